@@ -0,0 +1,169 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/any_sender_of.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/just.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/with_allocator.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+// Counts allocations made with the global operator new.
+static std::atomic<std::size_t> globalAllocations{0};
+
+void* operator new(std::size_t size) {
+  ++globalAllocations;
+  if (void* p = std::malloc(size != 0 ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct allocation_counts {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  explicit counting_allocator(allocation_counts& counts) noexcept
+    : counts_(&counts) {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other) noexcept
+    : counts_(other.counts_) {}
+
+  T* allocate(std::size_t n) {
+    ++counts_->allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    ++counts_->deallocations;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend bool operator==(counting_allocator a, counting_allocator b) noexcept {
+    return a.counts_ == b.counts_;
+  }
+
+  friend bool operator!=(counting_allocator a, counting_allocator b) noexcept {
+    return a.counts_ != b.counts_;
+  }
+
+  allocation_counts* counts_;
+};
+
+} // namespace
+
+int main() {
+  static_thread_pool pool{1};
+  auto scheduler = pool.get_scheduler();
+
+  // Senders of different types behind the same type.
+  std::vector<any_sender_of<int>> senders;
+  senders.push_back(just(1));
+  senders.push_back(transform(just(), [] { return 2; }));
+  senders.push_back(transform(cpo::schedule(scheduler), [] { return 3; }));
+  int total = 0;
+  for (auto& sender : senders) {
+    total += sync_wait(std::move(sender)).value();
+  }
+  if (total != 6) {
+    std::printf("any_sender_of didn't complete with the values\n");
+    return 1;
+  }
+
+  // Small senders are stored inline, even when moved.
+  const std::size_t allocationsBefore = globalAllocations.load();
+  {
+    any_sender_of<int> small{just(7)};
+    any_sender_of<int> moved{std::move(small)};
+  }
+  if (globalAllocations.load() != allocationsBefore) {
+    std::printf("any_sender_of allocated a small sender\n");
+    return 1;
+  }
+
+  // Small operations are stored inline and big ones use the receiver's
+  // allocator.
+  allocation_counts counts;
+  counting_allocator<std::byte> alloc{counts};
+  if (sync_wait(with_allocator(any_sender_of<int>{just(4)}, alloc)) != 4 ||
+      counts.allocations != 0) {
+    std::printf("any_sender_of allocated a small operation\n");
+    return 1;
+  }
+  if (sync_wait(with_allocator(basic_any_sender_of<0, int>{just(5)}, alloc)) !=
+          5 ||
+      counts.allocations != 1 || counts.deallocations != 1) {
+    std::printf("any_sender_of didn't use the receiver's allocator\n");
+    return 1;
+  }
+
+  try {
+    sync_wait(any_sender_of<int>{
+        transform(just(), []() -> int { throw std::runtime_error{"oops"}; })});
+    std::printf("any_sender_of didn't complete with the error\n");
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+
+  // Stop requests reach the concrete sender.
+  timed_single_thread_context context;
+  inplace_stop_source stopSource;
+  stopSource.request_stop();
+  auto start = std::chrono::steady_clock::now();
+  if (sync_wait(
+          any_sender_of<int>{transform(
+              cpo::schedule_after(context.get_scheduler(), 1h),
+              [] { return 6; })},
+          stopSource.get_token()) ||
+      std::chrono::steady_clock::now() - start > 10s) {
+    std::printf("any_sender_of didn't stop\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
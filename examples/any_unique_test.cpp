@@ -20,6 +20,7 @@
 #include <experimental/memory_resource>
 #include <string>
 #include <typeindex>
+#include <utility>
 
 template <typename T>
 using is_type_index = std::is_same<std::type_index, T>;
@@ -50,6 +51,19 @@ struct destructor {
   bool& ref_;
 };
 
+// Counts how many times an object that hasn't been moved from is destroyed.
+struct counted_destructor {
+  explicit counted_destructor(int& count) noexcept : count_(&count) {}
+  counted_destructor(counted_destructor&& other) noexcept
+    : count_(std::exchange(other.count_, nullptr)) {}
+  ~counted_destructor() {
+    if (count_ != nullptr) {
+      ++*count_;
+    }
+  }
+  int* count_;
+};
+
 using namespace std::experimental::pmr;
 
 class counting_memory_resource : public memory_resource {
@@ -114,5 +128,33 @@ int main() {
     }
     assert(res.total_allocated_bytes() == 0);
   }
+  {
+    using S = unifex::any_unique_sbo_t<2 * sizeof(void*), get_typeid>;
+    counting_memory_resource res{new_delete_resource()};
+    polymorphic_allocator<char> alloc{&res};
+
+    // Small objects are stored inline and moved with the any_unique_sbo.
+    int destroyed = 0;
+    {
+      S s1{std::allocator_arg,
+           alloc,
+           std::in_place_type<counted_destructor>,
+           destroyed};
+      assert(res.total_allocated_bytes() == 0);
+      S s2{std::move(s1)};
+      assert(get_typeid(s2) == typeid(counted_destructor));
+      assert(destroyed == 0);
+    }
+    assert(destroyed == 1);
+
+    // Big ones are still allocated.
+    {
+      S s1{std::string("hello"), alloc};
+      assert(res.total_allocated_bytes() >= sizeof(std::string));
+      S s2{std::move(s1)};
+      assert(get_typeid(s2) == typeid(std::string));
+    }
+    assert(res.total_allocated_bytes() == 0);
+  }
   return 0;
 }
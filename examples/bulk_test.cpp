@@ -0,0 +1,147 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/bulk.hpp>
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/just.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/trampoline_scheduler.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+
+bool check_doubled(const std::optional<std::vector<int>>& result, int size) {
+  if (!result || static_cast<int>(result->size()) != size) {
+    return false;
+  }
+  for (int i = 0; i < size; ++i) {
+    if ((*result)[i] != 2 * i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const auto double_index = [](int i, std::vector<int>& v) {
+  v[i] = 2 * i;
+};
+
+} // namespace
+
+int main() {
+  constexpr int size = 10'000;
+
+  // Sequentially, on the thread the predecessor completes on.
+  if (!check_doubled(
+          sync_wait(
+              cpo::bulk(just(std::vector<int>(size)), size, double_index)),
+          size)) {
+    std::printf("sequential bulk failed\n");
+    return 1;
+  }
+
+  // Inline and trampoline schedulers fall back to running sequentially.
+  static_assert(instance_of_v<
+                bulk_sender,
+                decltype(cpo::bulk(
+                    just(std::vector<int>{}),
+                    inline_scheduler{},
+                    size,
+                    double_index))>);
+  static_assert(instance_of_v<
+                bulk_sender,
+                decltype(cpo::bulk(
+                    just(std::vector<int>{}),
+                    trampoline_scheduler{},
+                    size,
+                    double_index))>);
+  if (!check_doubled(
+          sync_wait(cpo::bulk(
+              just(std::vector<int>(size)),
+              trampoline_scheduler{},
+              size,
+              double_index)),
+          size)) {
+    std::printf("trampoline bulk failed\n");
+    return 1;
+  }
+
+  static_thread_pool pool{4};
+  auto scheduler = pool.get_scheduler();
+
+  // One chunk per worker.
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<int> calls = 0;
+  if (!check_doubled(
+          sync_wait(cpo::bulk(
+              just(std::vector<int>(size)),
+              scheduler,
+              size,
+              [&](int i, std::vector<int>& v) {
+                if (calls++ % 1000 == 0) {
+                  std::lock_guard lock{mutex};
+                  threads.insert(std::this_thread::get_id());
+                }
+                v[i] = 2 * i;
+              })),
+          size)) {
+    std::printf("pool bulk failed\n");
+    return 1;
+  }
+  if (calls.load() != size || threads.count(std::this_thread::get_id()) != 0) {
+    std::printf("pool bulk ran in the wrong place\n");
+    return 1;
+  }
+
+  // Fewer elements than workers, and no elements at all.
+  if (!check_doubled(
+          sync_wait(cpo::bulk(
+              just(std::vector<int>(3)), scheduler, 3, double_index)),
+          3) ||
+      !check_doubled(
+          sync_wait(cpo::bulk(
+              just(std::vector<int>{}), scheduler, 0, double_index)),
+          0)) {
+    std::printf("small pool bulk failed\n");
+    return 1;
+  }
+
+  // An exception from one element fails the whole operation.
+  try {
+    sync_wait(cpo::bulk(just(), scheduler, size, [](int i) {
+      if (i == size / 2) {
+        throw std::runtime_error("failed");
+      }
+    }));
+    std::printf("bulk error was not propagated\n");
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+
+  std::printf("success\n");
+  return 0;
+}
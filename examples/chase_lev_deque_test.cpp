@@ -0,0 +1,93 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/detail/chase_lev_deque.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+struct item {
+  std::atomic<int> takenCount{0};
+};
+
+int main() {
+  // Single-threaded: LIFO for the owner, FIFO for thieves, and growing
+  // past the initial capacity.
+  {
+    chase_lev_deque<item> deque{2};
+    std::vector<item> items(100);
+    for (auto& i : items) {
+      deque.push(&i);
+    }
+    if (deque.size() != 100 || deque.steal() != &items[0] ||
+        deque.pop() != &items[99] || deque.size() != 98) {
+      std::printf("wrong order\n");
+      return 1;
+    }
+    while (deque.pop() != nullptr) {
+    }
+    if (!deque.empty() || deque.steal() != nullptr) {
+      std::printf("deque not empty\n");
+      return 1;
+    }
+  }
+
+  // The owner pushes and pops while thieves steal. Every item must be
+  // taken exactly once.
+  constexpr int itemCount = 200'000;
+  constexpr int thiefCount = 3;
+  chase_lev_deque<item> deque{4};
+  std::vector<item> items(itemCount);
+  std::atomic<bool> ownerDone = false;
+
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < thiefCount; ++t) {
+    thieves.emplace_back([&] {
+      while (!ownerDone.load() || !deque.empty()) {
+        if (item* i = deque.steal()) {
+          i->takenCount.fetch_add(1);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < itemCount; ++i) {
+    deque.push(&items[i]);
+    if (i % 3 == 0) {
+      if (item* popped = deque.pop()) {
+        popped->takenCount.fetch_add(1);
+      }
+    }
+  }
+  ownerDone.store(true);
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+
+  for (int i = 0; i < itemCount; ++i) {
+    if (items[i].takenCount.load() != 1) {
+      std::printf(
+          "item %i taken %i times\n", i, items[i].takenCount.load());
+      return 1;
+    }
+  }
+
+  std::printf("success\n");
+  return 0;
+}
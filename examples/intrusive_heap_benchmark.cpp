@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/detail/intrusive_heap.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace unifex;
+
+// Measures the cost of the timer-like workloads on intrusive_heap for a
+// range of heap sizes:
+// - insert:  inserting N items with random due times.
+// - remove:  removing every other item (as if cancelled).
+// - pop:     popping the remaining items in due-time order.
+// - churn:   with N items in the heap, repeatedly popping the earliest item
+//            and re-inserting it with a later due time.
+
+namespace {
+
+struct timer {
+  timer* child_ = nullptr;
+  timer* next_ = nullptr;
+  timer* prev_ = nullptr;
+  std::uint64_t dueTime_ = 0;
+};
+
+using timer_heap = intrusive_heap<
+    timer,
+    &timer::child_,
+    &timer::next_,
+    &timer::prev_,
+    std::uint64_t,
+    &timer::dueTime_>;
+
+using clock = std::chrono::steady_clock;
+
+double nanoseconds_per_item(clock::time_point start, std::size_t count) {
+  return std::chrono::duration<double, std::nano>(clock::now() - start)
+             .count() /
+      count;
+}
+
+void run_benchmark(std::size_t count) {
+  std::mt19937_64 rng{count};
+  std::vector<timer> timers(count);
+  for (auto& t : timers) {
+    t.dueTime_ = rng() % (count * 16);
+  }
+
+  timer_heap heap;
+
+  auto start = clock::now();
+  for (auto& t : timers) {
+    heap.insert(&t);
+  }
+  const double insert = nanoseconds_per_item(start, count);
+
+  start = clock::now();
+  for (std::size_t i = 0; i < count; i += 2) {
+    heap.remove(&timers[i]);
+  }
+  const double remove = nanoseconds_per_item(start, (count + 1) / 2);
+
+  start = clock::now();
+  std::uint64_t last = 0;
+  std::size_t popped = 0;
+  while (!heap.empty()) {
+    timer* t = heap.pop();
+    if (t->dueTime_ < last) {
+      std::printf("error: items popped out of order\n");
+    }
+    last = t->dueTime_;
+    ++popped;
+  }
+  const double pop = nanoseconds_per_item(start, popped);
+
+  for (auto& t : timers) {
+    heap.insert(&t);
+  }
+  const std::size_t churnCount = 1'000'000;
+  start = clock::now();
+  for (std::size_t i = 0; i < churnCount; ++i) {
+    timer* t = heap.pop();
+    t->dueTime_ += rng() % (count * 16);
+    heap.insert(t);
+  }
+  const double churn = nanoseconds_per_item(start, churnCount);
+  while (!heap.empty()) {
+    (void)heap.pop();
+  }
+
+  std::printf(
+      "%10zu %12.1f %12.1f %12.1f %12.1f\n",
+      count,
+      insert,
+      remove,
+      pop,
+      churn);
+}
+
+} // namespace
+
+int main() {
+  std::printf(
+      "%10s %12s %12s %12s %12s\n",
+      "timers",
+      "insert ns",
+      "remove ns",
+      "pop ns",
+      "churn ns");
+  for (std::size_t count : {1'000u, 100'000u, 1'000'000u}) {
+    run_benchmark(count);
+  }
+  return 0;
+}
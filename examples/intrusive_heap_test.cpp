@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/detail/intrusive_heap.hpp>
+
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace unifex;
+
+struct item {
+  item* child_ = nullptr;
+  item* next_ = nullptr;
+  item* prev_ = nullptr;
+  int key_ = 0;
+  bool inHeap_ = false;
+};
+
+using heap = intrusive_heap<
+    item,
+    &item::child_,
+    &item::next_,
+    &item::prev_,
+    int,
+    &item::key_>;
+
+int main() {
+  std::mt19937 rng{12345};
+  std::vector<item> items(2000);
+  std::multiset<int> expected;
+  heap h;
+
+  // Randomly interleave insert(), pop() and remove() of arbitrary items,
+  // checking the top of the heap against a std::multiset each time.
+  for (int step = 0; step < 200000; ++step) {
+    item& i = items[rng() % items.size()];
+    const unsigned action = rng() % 3;
+    if (!i.inHeap_) {
+      i.key_ = static_cast<int>(rng() % 500);
+      i.inHeap_ = true;
+      h.insert(&i);
+      expected.insert(i.key_);
+    } else if (action == 0) {
+      h.remove(&i);
+      i.inHeap_ = false;
+      expected.erase(expected.find(i.key_));
+    } else if (action == 1) {
+      item* top = h.pop();
+      if (top->key_ != *expected.begin()) {
+        std::printf("pop() returned %i, expected %i\n", top->key_,
+                    *expected.begin());
+        return 1;
+      }
+      top->inHeap_ = false;
+      expected.erase(expected.begin());
+    }
+
+    if (h.empty() != expected.empty()) {
+      std::printf("heap emptiness is wrong at step %i\n", step);
+      return 1;
+    }
+    if (!h.empty() && h.top()->key_ != *expected.begin()) {
+      std::printf("top() is %i, expected %i at step %i\n", h.top()->key_,
+                  *expected.begin(), step);
+      return 1;
+    }
+  }
+
+  // Draining the heap produces the keys in ascending order.
+  while (!h.empty()) {
+    item* top = h.pop();
+    if (top->key_ != *expected.begin()) {
+      std::printf("drained %i, expected %i\n", top->key_, *expected.begin());
+      return 1;
+    }
+    expected.erase(expected.begin());
+  }
+
+  std::printf("success\n");
+  return 0;
+}
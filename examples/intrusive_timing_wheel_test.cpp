@@ -0,0 +1,133 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/detail/intrusive_timing_wheel.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+using time_point = std::chrono::steady_clock::time_point;
+
+struct item {
+  item* next_ = nullptr;
+  item** prev_ = nullptr;
+  time_point dueTime_;
+};
+
+using wheel = intrusive_timing_wheel<
+    item,
+    &item::next_,
+    &item::prev_,
+    time_point,
+    &item::dueTime_>;
+
+int main() {
+  // Simulate time with a 1ms tick, moving in steps from sub-tick up to
+  // several hours so that items cascade through every level of the wheel
+  // and past its range.
+  const time_point origin{};
+  const auto tick = 1ms;
+  wheel w{origin, tick};
+
+  std::mt19937_64 rng{42};
+  std::vector<item> items(3000);
+  std::set<item*> pending;
+  time_point now = origin;
+
+  const auto random_delay = [&]() -> std::chrono::nanoseconds {
+    switch (rng() % 5) {
+      case 0: return std::chrono::microseconds(rng() % 2000);
+      case 1: return std::chrono::milliseconds(rng() % 100);
+      case 2: return std::chrono::milliseconds(rng() % 10'000);
+      case 3: return std::chrono::seconds(rng() % 3'600);
+      default: return std::chrono::hours(rng() % 400);
+    }
+  };
+
+  for (int step = 0; step < 20000; ++step) {
+    // Insert or cancel some items.
+    for (int i = 0; i < 4; ++i) {
+      item& it = items[rng() % items.size()];
+      if (it.prev_ == nullptr) {
+        // Occasionally insert an item that is already overdue.
+        it.dueTime_ = (rng() % 20 == 0) ? now - 5ms : now + random_delay();
+        w.insert(&it);
+        pending.insert(&it);
+      } else if (rng() % 3 == 0) {
+        w.remove(&it);
+        pending.erase(&it);
+        if (it.prev_ != nullptr) {
+          std::printf("removed item is still linked\n");
+          return 1;
+        }
+      }
+    }
+
+    // Either advance time a little or jump to the next expiry.
+    auto next = w.next_expiry_time();
+    if (next && *next > now && rng() % 4 == 0) {
+      now = *next;
+    } else {
+      now += random_delay() / (1 + rng() % 1000);
+    }
+
+    auto expired = w.pop_expired(now);
+    while (!expired.empty()) {
+      item* it = expired.pop_front();
+      if (it->dueTime_ > now) {
+        std::printf("item expired early at step %i\n", step);
+        return 1;
+      }
+      if (it->prev_ != nullptr || pending.erase(it) != 1) {
+        std::printf("unexpected item expired at step %i\n", step);
+        return 1;
+      }
+    }
+
+    // Everything due at or before the start of the current tick must have
+    // been returned, and the next expiry time must be no later than the
+    // tick after the earliest pending due time.
+    const time_point tickStart = origin + (now - origin) / tick * tick;
+    next = w.next_expiry_time();
+    for (item* it : pending) {
+      if (it->dueTime_ <= tickStart) {
+        std::printf("item not expired at step %i\n", step);
+        return 1;
+      }
+      if (!next || *next > it->dueTime_ + tick) {
+        std::printf("next expiry time is too late at step %i\n", step);
+        return 1;
+      }
+    }
+
+    if (w.empty() != pending.empty()) {
+      std::printf("wheel emptiness is wrong at step %i\n", step);
+      return 1;
+    }
+  }
+
+  for (item* it : pending) {
+    w.remove(it);
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+static constexpr unsigned char data[6] = {'h', 'e', 'l', 'l', 'o', '\n'};
+
+int main() {
+  io_uring_context ctx;
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  auto scheduler = ctx.get_scheduler();
+
+  const char* path = "io_uring_async_file_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  try {
+    {
+      auto file = sync_wait(async_open_file_read_write(scheduler, path));
+      if (!file) {
+        std::printf("open cancelled\n");
+        return 1;
+      }
+
+      auto bytesWritten =
+          sync_wait(async_write_some_at(*file, 0, as_bytes(span{data})));
+      if (!bytesWritten || *bytesWritten != sizeof(data)) {
+        std::printf("write failed\n");
+        return 1;
+      }
+
+      sync_wait(async_fdatasync(*file));
+      sync_wait(async_fallocate(*file, 0, 0, 4096));
+      sync_wait(async_fsync(*file));
+
+      auto info = sync_wait(async_statx(*file));
+      if (!info || info->stx_size != 4096) {
+        std::printf("unexpected file size after fallocate\n");
+        return 1;
+      }
+
+      sync_wait(async_close(*file));
+    }
+
+    {
+      auto file = sync_wait(async_open_file_read_only(scheduler, path));
+
+      unsigned char buffer[sizeof(data)] = {};
+      auto bytesRead = sync_wait(async_read_some_at(
+          *file, 0, as_writable_bytes(span{buffer, sizeof(buffer)})));
+      if (!bytesRead || *bytesRead != sizeof(data) ||
+          std::memcmp(buffer, data, sizeof(data)) != 0) {
+        std::printf("read failed\n");
+        return 1;
+      }
+
+      sync_wait(async_close(*file));
+
+      // Once closed the file no longer refers to an open file descriptor.
+      bool failed = false;
+      try {
+        sync_wait(async_statx(*file));
+      } catch (const std::error_code&) {
+        failed = true;
+      }
+      if (!failed) {
+        std::printf("statx on a closed file succeeded\n");
+        return 1;
+      }
+    }
+
+    // Errors from the kernel are reported through set_error().
+    bool failed = false;
+    try {
+      sync_wait(async_open_file_read_only(scheduler, "does/not/exist"));
+    } catch (const std::error_code& ec) {
+      failed = ec.value() == ENOENT;
+    }
+    if (!failed) {
+      std::printf("opening a missing file did not fail with ENOENT\n");
+      return 1;
+    }
+  } catch (const std::error_code& ec) {
+    std::printf("error: %s\n", ec.message().c_str());
+    return 1;
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+using namespace std::chrono_literals;
+
+int main() {
+  io_uring_context ctx;
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  // Reads from an empty pipe don't complete until something is written,
+  // so they can only finish early by being cancelled.
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    std::perror("pipe");
+    return 1;
+  }
+  safe_file_descriptor readEnd{fds[0]};
+  safe_file_descriptor writeEnd{fds[1]};
+
+  char buffer[16];
+  auto readPipe = [&] {
+    return io_uring_context::read_sender{
+        ctx,
+        readEnd.get(),
+        0,
+        as_writable_bytes(span{buffer, sizeof(buffer)})};
+  };
+
+  try {
+    {
+      // Stop requested before the read is started.
+      inplace_stop_source readStopSource;
+      readStopSource.request_stop();
+      auto result = sync_wait(readPipe(), readStopSource.get_token());
+      if (result) {
+        std::printf("read completed despite stop being requested\n");
+        return 1;
+      }
+    }
+
+    {
+      // Stop requested while the read is in flight.
+      inplace_stop_source readStopSource;
+      std::thread canceller{[&] {
+        std::this_thread::sleep_for(50ms);
+        readStopSource.request_stop();
+      }};
+      scope_guard joinCanceller = [&]() noexcept { canceller.join(); };
+
+      auto start = std::chrono::steady_clock::now();
+      auto result = sync_wait(readPipe(), readStopSource.get_token());
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      if (result) {
+        std::printf("read completed despite being cancelled\n");
+        return 1;
+      }
+      std::printf(
+          "cancelled after %i ms\n",
+          (int)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+              .count());
+    }
+
+    {
+      // The pipe is still usable after the cancelled reads.
+      if (::write(writeEnd.get(), "x", 1) != 1) {
+        std::perror("write");
+        return 1;
+      }
+      inplace_stop_source readStopSource;
+      auto result = sync_wait(readPipe(), readStopSource.get_token());
+      if (!result || *result != 1 || buffer[0] != 'x') {
+        std::printf("read after cancellation failed\n");
+        return 1;
+      }
+    }
+  } catch (const std::error_code& ec) {
+    std::printf("error: %s\n", ec.message().c_str());
+    return 1;
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
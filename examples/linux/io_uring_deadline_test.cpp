@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+using namespace std::chrono_literals;
+
+static constexpr unsigned char data[6] = {'h', 'e', 'l', 'l', 'o', '\n'};
+
+int main() {
+  io_uring_context ctx;
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  auto scheduler = ctx.get_scheduler();
+
+  const char* path = "io_uring_deadline_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  // Reads from an empty pipe don't complete until something is written.
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    std::perror("pipe");
+    return 1;
+  }
+  io_uring_context::async_read_only_file pipe{ctx, fds[0]};
+  safe_file_descriptor writeEnd{fds[1]};
+
+  try {
+    {
+      // I/O that completes well before its deadline.
+      auto file = open_file_read_write(scheduler, path);
+      auto bytesWritten = sync_wait(async_write_some_at_until(
+          file, 0, as_bytes(span{data}), scheduler.now() + 10s));
+      if (!bytesWritten || *bytesWritten != sizeof(data)) {
+        std::printf("write before deadline failed\n");
+        return 1;
+      }
+
+      unsigned char buffer[sizeof(data)] = {};
+      auto bytesRead = sync_wait(async_read_some_at_until(
+          file,
+          0,
+          as_writable_bytes(span{buffer, sizeof(buffer)}),
+          scheduler.now() + 10s));
+      if (!bytesRead || *bytesRead != sizeof(data) ||
+          std::memcmp(buffer, data, sizeof(data)) != 0) {
+        std::printf("read before deadline failed\n");
+        return 1;
+      }
+    }
+
+    char buffer[16];
+    auto pipeBuffer = as_writable_bytes(span{buffer, sizeof(buffer)});
+
+    {
+      // I/O that doesn't complete by its deadline.
+      auto start = std::chrono::steady_clock::now();
+      bool timedOut = false;
+      try {
+        sync_wait(async_read_some_at_until(
+            pipe, 0, pipeBuffer, scheduler.now() + 50ms));
+      } catch (const std::error_code& ec) {
+        timedOut = ec == std::errc::timed_out;
+      }
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      if (!timedOut || elapsed < 50ms) {
+        std::printf("read did not time out at its deadline\n");
+        return 1;
+      }
+      std::printf(
+          "timed out after %i ms\n",
+          (int)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+              .count());
+    }
+
+    {
+      // A deadline that has already passed.
+      bool timedOut = false;
+      try {
+        sync_wait(
+            async_read_some_at_until(pipe, 0, pipeBuffer, scheduler.now()));
+      } catch (const std::error_code& ec) {
+        timedOut = ec == std::errc::timed_out;
+      }
+      if (!timedOut) {
+        std::printf("read with an elapsed deadline did not time out\n");
+        return 1;
+      }
+    }
+
+    {
+      // Stopping an operation that has a deadline completes with done.
+      inplace_stop_source readStopSource;
+      std::thread canceller{[&] {
+        std::this_thread::sleep_for(20ms);
+        readStopSource.request_stop();
+      }};
+      scope_guard joinCanceller = [&]() noexcept { canceller.join(); };
+
+      auto result = sync_wait(
+          async_read_some_at_until(pipe, 0, pipeBuffer, scheduler.now() + 10s),
+          readStopSource.get_token());
+      if (result) {
+        std::printf("read completed despite being cancelled\n");
+        return 1;
+      }
+    }
+
+    {
+      // The pipe is still usable after the timed out reads.
+      if (::write(writeEnd.get(), "x", 1) != 1) {
+        std::perror("write");
+        return 1;
+      }
+      auto result = sync_wait(async_read_some_at_until(
+          pipe, 0, pipeBuffer, scheduler.now() + 10s));
+      if (!result || *result != 1 || buffer[0] != 'x') {
+        std::printf("read after timeout failed\n");
+        return 1;
+      }
+    }
+  } catch (const std::error_code& ec) {
+    std::printf("error: %s\n", ec.message().c_str());
+    return 1;
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/linux/io_uring_pool.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sender_concepts.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+// Measures the aggregate throughput of small reads against a single file as
+// the number of rings (and threads) in an io_uring_pool is varied.
+//
+// Each round starts 'inflight' concurrent reads from the main thread. The
+// pool's placement policy decides which ring each read is submitted to.
+//
+// Usage: io_uring_pool_benchmark [rounds] [pin] [hash]
+//
+// Passing 'pin' pins each ring's thread to a CPU. Passing 'hash' uses the
+// hash_by_fd placement policy, which puts all reads of the file on one ring.
+
+namespace {
+
+constexpr std::size_t blockSize = 4096;
+constexpr std::size_t blockCount = 256;
+
+struct round_state {
+  std::atomic<std::size_t> remaining{0};
+  std::atomic<std::size_t> errors{0};
+};
+
+struct read_receiver {
+  round_state& state_;
+
+  void value(ssize_t) && noexcept {
+    state_.remaining.fetch_sub(1, std::memory_order_release);
+  }
+
+  void error(std::error_code) && noexcept {
+    state_.errors.fetch_add(1, std::memory_order_relaxed);
+    state_.remaining.fetch_sub(1, std::memory_order_release);
+  }
+
+  void done() && noexcept {
+    state_.remaining.fetch_sub(1, std::memory_order_release);
+  }
+};
+
+using read_operation =
+    operation_t<io_uring_context::read_sender, read_receiver>;
+
+double run_benchmark(
+    std::uint32_t ringCount,
+    int fd,
+    std::size_t inflight,
+    std::size_t rounds,
+    bool pin,
+    bool hash) {
+  io_uring_pool::options opts;
+  opts.ringCount = ringCount;
+  opts.pinThreads = pin;
+  opts.placement = hash ? io_uring_pool::placement_policy::hash_by_fd
+                        : io_uring_pool::placement_policy::least_pending;
+  opts.contextOptions.submissionQueueEntries = 1024;
+  io_uring_pool pool{opts};
+
+  std::vector<std::byte> buffers(inflight * blockSize);
+  std::vector<manual_lifetime<read_operation>> ops(inflight);
+
+  round_state state;
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    state.remaining.store(inflight, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < inflight; ++i) {
+      ops[i].construct_from([&] {
+        return cpo::connect(
+            io_uring_context::read_sender{
+                pool.select_context(fd),
+                fd,
+                ((round * inflight + i) % blockCount) * blockSize,
+                span<std::byte>{buffers.data() + i * blockSize, blockSize}},
+            read_receiver{state});
+      });
+      cpo::start(ops[i].get());
+    }
+
+    while (state.remaining.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+
+    for (auto& op : ops) {
+      op.destruct();
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  if (state.errors.load() != 0) {
+    std::printf("warning: %zu reads failed\n", state.errors.load());
+  }
+
+  auto seconds = std::chrono::duration<double>(end - start).count();
+  return double(inflight * rounds) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+  bool pin = false;
+  bool hash = false;
+  for (int i = 2; i < argc; ++i) {
+    pin = pin || std::strcmp(argv[i], "pin") == 0;
+    hash = hash || std::strcmp(argv[i], "hash") == 0;
+  }
+  const std::size_t inflight = 1024;
+
+  char path[] = "/tmp/io_uring_pool_benchmark_XXXXXX";
+  int fd = ::mkstemp(path);
+  if (fd < 0) {
+    std::perror("mkstemp");
+    return 1;
+  }
+  scope_guard removeFile = [&]() noexcept {
+    ::close(fd);
+    ::unlink(path);
+  };
+
+  std::vector<char> block(blockSize, 'x');
+  for (std::size_t i = 0; i < blockCount; ++i) {
+    if (::write(fd, block.data(), block.size()) != ssize_t(block.size())) {
+      std::perror("write");
+      return 1;
+    }
+  }
+
+  const std::uint32_t maxRings =
+      std::max(2u, std::thread::hardware_concurrency());
+
+  std::printf("%8s %16s\n", "rings", "reads/sec");
+  for (std::uint32_t rings = 1; rings <= maxRings; rings *= 2) {
+    double rate = run_benchmark(rings, fd, inflight, rounds, pin, hash);
+    std::printf("%8u %16.0f\n", rings, rate);
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/linux/io_uring_pool.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+static constexpr unsigned char data[6] = {'h', 'e', 'l', 'l', 'o', '\n'};
+
+int main() {
+  io_uring_pool::options opts;
+  opts.ringCount = 3;
+  opts.pinThreads = true;
+  opts.placement = io_uring_pool::placement_policy::hash_by_fd;
+  io_uring_pool pool{opts};
+
+  if (pool.size() != 3) {
+    std::printf("unexpected ring count %zu\n", pool.size());
+    return 1;
+  }
+
+  const char* path = "io_uring_pool_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  try {
+    auto scheduler = pool.get_scheduler();
+
+    if (pool.current_context() != nullptr) {
+      std::printf("main thread is not a pool thread\n");
+      return 1;
+    }
+
+    // Work scheduled from outside the pool is spread across the idle rings.
+    std::set<io_uring_context*> used;
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+      auto context = sync_wait(transform(
+          scheduler.schedule(), [&] { return pool.current_context(); }));
+      if (!context || *context == nullptr) {
+        std::printf("work did not run on a pool thread\n");
+        return 1;
+      }
+      used.insert(*context);
+    }
+    if (used.size() != pool.size()) {
+      std::printf("idle rings were not used in turn\n");
+      return 1;
+    }
+
+    // Work scheduled from a pool thread stays on that thread's ring.
+    auto stayedLocal = sync_wait(transform(scheduler.schedule(), [&] {
+      return &pool.select_context() == pool.current_context() &&
+          &pool.select_context(42) == pool.current_context();
+    }));
+    if (!stayedLocal || !*stayedLocal) {
+      std::printf("work scheduled on a pool thread left its ring\n");
+      return 1;
+    }
+
+    // Files are placed on the ring selected by their file descriptor.
+    for (int fd = 0; fd < 6; ++fd) {
+      if (&pool.select_context(fd) != &pool.context(fd % pool.size())) {
+        std::printf("file descriptor %i was not hashed to its ring\n", fd);
+        return 1;
+      }
+    }
+
+    auto file = open_file_read_write(scheduler, path);
+    auto bytesWritten =
+        sync_wait(async_write_some_at(file, 0, as_bytes(span{data})));
+    if (!bytesWritten || *bytesWritten != sizeof(data)) {
+      std::printf("write failed\n");
+      return 1;
+    }
+
+    unsigned char buffer[sizeof(data)] = {};
+    auto bytesRead = sync_wait(async_read_some_at(
+        file, 0, as_writable_bytes(span{buffer, sizeof(buffer)})));
+    if (!bytesRead || *bytesRead != sizeof(data) ||
+        std::memcmp(buffer, data, sizeof(data)) != 0) {
+      std::printf("read failed\n");
+      return 1;
+    }
+  } catch (const std::error_code& ec) {
+    std::printf("error: %s\n", ec.message().c_str());
+    return 1;
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
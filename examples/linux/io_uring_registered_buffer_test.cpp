@@ -0,0 +1,129 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+int main() {
+  io_uring_context::options opts;
+  opts.registeredBufferSlots = 4;
+
+  std::optional<io_uring_context> ctx;
+  try {
+    ctx.emplace(opts);
+  } catch (const std::system_error& ex) {
+    // Sparse buffer registration requires Linux 5.19 or later.
+    std::printf("skipping, buffer registration not available: %s\n", ex.what());
+    return 0;
+  }
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx->run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  const char* path = "io_uring_registered_buffer_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  try {
+    io_uring_context::registered_buffer_pool pool{*ctx, 4096, 4};
+
+    auto writeBlock = pool.allocate();
+    auto readBlock = pool.allocate();
+    scope_guard freeBlocks = [&]() noexcept {
+      pool.deallocate(writeBlock);
+      pool.deallocate(readBlock);
+    };
+
+    for (std::size_t i = 0; i < writeBlock.size(); ++i) {
+      writeBlock[i] = std::byte(i % 251);
+    }
+
+    auto file = open_file_read_write(ctx->get_scheduler(), path);
+
+    // A write from a registered block followed by a read into another one.
+    auto bytesWritten = sync_wait(async_write_some_at(file, 0, writeBlock));
+    if (!bytesWritten || *bytesWritten != ssize_t(writeBlock.size())) {
+      std::printf("fixed write failed\n");
+      return 1;
+    }
+
+    auto bytesRead = sync_wait(async_read_some_at(file, 0, readBlock));
+    if (!bytesRead || *bytesRead != ssize_t(readBlock.size()) ||
+        std::memcmp(readBlock.data(), writeBlock.data(), readBlock.size()) !=
+            0) {
+      std::printf("fixed read failed\n");
+      return 1;
+    }
+
+    // A read into part of a registered block.
+    std::memset(readBlock.data(), 0, readBlock.size());
+    bytesRead = sync_wait(async_read_some_at(
+        file, 100, span<std::byte>{readBlock.data() + 10, 50}));
+    if (!bytesRead || *bytesRead != 50 ||
+        std::memcmp(readBlock.data() + 10, writeBlock.data() + 100, 50) != 0) {
+      std::printf("partial fixed read failed\n");
+      return 1;
+    }
+
+    // Buffers that are not registered still work.
+    std::byte unregistered[64] = {};
+    bytesRead = sync_wait(async_read_some_at(
+        file, 0, span<std::byte>{unregistered, sizeof(unregistered)}));
+    if (!bytesRead || *bytesRead != ssize_t(sizeof(unregistered)) ||
+        std::memcmp(unregistered, writeBlock.data(), sizeof(unregistered)) !=
+            0) {
+      std::printf("unregistered read failed\n");
+      return 1;
+    }
+
+    // The pool hands out each block only once.
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    bool exhausted = false;
+    try {
+      (void)pool.allocate();
+    } catch (const std::bad_alloc&) {
+      exhausted = true;
+    }
+    pool.deallocate(a);
+    pool.deallocate(b);
+    if (!exhausted) {
+      std::printf("pool allocated more blocks than it holds\n");
+      return 1;
+    }
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+static constexpr unsigned char data[6] = {'h', 'e', 'l', 'l', 'o', '\n'};
+
+int main() {
+  io_uring_context::options opts;
+  opts.registeredFileSlots = 2;
+
+  std::optional<io_uring_context> ctx;
+  try {
+    ctx.emplace(opts);
+  } catch (const std::system_error& ex) {
+    // Sparse file registration requires Linux 5.19 or later.
+    std::printf("skipping, file registration not available: %s\n", ex.what());
+    return 0;
+  }
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx->run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  const char* path = "io_uring_registered_file_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  try {
+    auto scheduler = ctx->get_scheduler();
+
+    {
+      auto writer = open_file_write_only(scheduler, path);
+      writer.register_fixed_file();
+
+      auto bytesWritten =
+          sync_wait(async_write_some_at(writer, 0, as_bytes(span{data})));
+      if (!bytesWritten || *bytesWritten != sizeof(data)) {
+        std::printf("fixed write failed\n");
+        return 1;
+      }
+    }
+
+    auto reader = open_file_read_only(scheduler, path);
+    reader.register_fixed_file();
+
+    // The writer's slot was released when it was closed so one slot
+    // remains, which this file takes.
+    auto other = open_file_read_write(scheduler, path);
+    other.register_fixed_file();
+
+    // All slots are now in use.
+    auto unregistered = open_file_read_only(scheduler, path);
+    bool noSlots = false;
+    try {
+      unregistered.register_fixed_file();
+    } catch (const std::system_error&) {
+      noSlots = true;
+    }
+    if (!noSlots) {
+      std::printf("registered more files than there are slots\n");
+      return 1;
+    }
+
+    auto checkRead = [&](auto& file, const char* name) {
+      unsigned char buffer[sizeof(data)] = {};
+      auto bytesRead = sync_wait(async_read_some_at(
+          file, 0, as_writable_bytes(span{buffer, sizeof(buffer)})));
+      if (!bytesRead || *bytesRead != sizeof(data) ||
+          std::memcmp(buffer, data, sizeof(data)) != 0) {
+        std::printf("%s read failed\n", name);
+        return false;
+      }
+      return true;
+    };
+
+    if (!checkRead(reader, "fixed") || !checkRead(other, "fixed") ||
+        !checkRead(unregistered, "unregistered")) {
+      return 1;
+    }
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/typed_via.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+// Measures the latency of waking up an idle io_uring_context from another
+// thread.
+//
+// 'thread -> ring' schedules onto ring A from the main thread, which wakes A
+// by writing to its eventfd. 'ring -> ring' additionally hops from A to ring B
+// which is woken by a message posted from A's ring.
+//
+// Usage: io_uring_remote_wakeup_benchmark [iterations]
+
+template <typename Func>
+static double average_microseconds(std::size_t iterations, Func func) {
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    func();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+      iterations;
+}
+
+int main(int argc, char** argv) {
+  const std::size_t iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+  // Both contexts outlive both threads so they can be in one wakeup group.
+  io_uring_context::options opts;
+  opts.wakeupGroup = &opts;
+  io_uring_context ctxA{opts};
+  io_uring_context ctxB{opts};
+
+  inplace_stop_source stopSource;
+  std::thread threadA{[&] { ctxA.run(stopSource.get_token()); }};
+  std::thread threadB{[&] { ctxB.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    threadA.join();
+    threadB.join();
+  };
+
+  auto schedA = ctxA.get_scheduler();
+  auto schedB = ctxB.get_scheduler();
+
+  const double threadToRing = average_microseconds(
+      iterations, [&] { sync_wait(schedA.schedule()); });
+  const double ringToRing = average_microseconds(iterations, [&] {
+    sync_wait(typed_via(schedB.schedule(), schedA.schedule()));
+  });
+
+  std::printf("%16s %12s\n", "path", "us/wakeup");
+  std::printf("%16s %12.2f\n", "thread -> ring", threadToRing);
+  std::printf(
+      "%16s %12.2f\n", "ring -> ring", ringToRing - threadToRing);
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/typed_via.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+using namespace unifex;
+using namespace unifex::linux;
+using namespace std::chrono_literals;
+
+int main() {
+  // Both contexts outlive both threads so they can be in one wakeup group.
+  io_uring_context::options opts;
+  opts.wakeupGroup = &opts;
+  io_uring_context ctxA{opts};
+  io_uring_context ctxB{opts};
+
+  inplace_stop_source stopSource;
+  std::thread threadA{[&] { ctxA.run(stopSource.get_token()); }};
+  std::thread threadB{[&] { ctxB.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    threadA.join();
+    threadB.join();
+  };
+
+  auto schedA = ctxA.get_scheduler();
+  auto schedB = ctxB.get_scheduler();
+
+  try {
+    // Hop from ring A to ring B repeatedly. The hop is scheduled from A's
+    // I/O thread so B is woken by a message from A's ring (or its eventfd if
+    // the kernel does not support IORING_OP_MSG_RING).
+    for (int i = 0; i < 1000; ++i) {
+      auto threads = sync_wait(transform(
+          typed_via(
+              schedB.schedule(),
+              transform(
+                  schedA.schedule(), [] { return std::this_thread::get_id(); })),
+          [](std::thread::id first) {
+            return std::make_pair(first, std::this_thread::get_id());
+          }));
+      if (!threads || threads->first != threadA.get_id() ||
+          threads->second != threadB.get_id()) {
+        std::printf("hop %i did not run on the expected threads\n", i);
+        return 1;
+      }
+    }
+
+    // Give both rings time to go idle so the next wakeups find the remote
+    // queues marked inactive.
+    std::this_thread::sleep_for(10ms);
+
+    // Wakeups from a thread that isn't running a context still work, both
+    // directly and after a ring-to-ring hop.
+    for (int i = 0; i < 100; ++i) {
+      if (!sync_wait(schedA.schedule()) ||
+          !sync_wait(typed_via(schedA.schedule(), schedB.schedule()))) {
+        std::printf("remote schedule %i did not complete\n", i);
+        return 1;
+      }
+      if (i % 10 == 0) {
+        std::this_thread::sleep_for(1ms);
+      }
+    }
+  } catch (const std::error_code& ec) {
+    std::printf("error: %s\n", ec.message().c_str());
+    return 1;
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sender_concepts.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+// Measures the throughput of small reads against a single file as the
+// depth of the io_uring submission/completion queues is varied.
+//
+// Each round starts 'inflight' concurrent reads, which is deliberately more
+// than the smallest ring sizes can hold, so that shallow rings end up queueing
+// work in the context's pending-I/O queue.
+//
+// Usage: io_uring_ring_depth_benchmark [rounds] [sqpoll] [fixed] [fixedfile]
+//
+// Passing 'sqpoll' runs the context with kernel submission queue polling
+// enabled. Passing 'fixed' reads into blocks from a registered buffer pool.
+// Passing 'fixedfile' reads from the file through a registered file slot.
+
+namespace {
+
+constexpr std::size_t blockSize = 4096;
+constexpr std::size_t blockCount = 256;
+
+struct round_state {
+  std::atomic<std::size_t> remaining{0};
+  std::atomic<std::size_t> errors{0};
+};
+
+struct read_receiver {
+  round_state& state_;
+
+  void value(ssize_t) && noexcept {
+    state_.remaining.fetch_sub(1, std::memory_order_release);
+  }
+
+  void error(std::error_code) && noexcept {
+    state_.errors.fetch_add(1, std::memory_order_relaxed);
+    state_.remaining.fetch_sub(1, std::memory_order_release);
+  }
+
+  void done() && noexcept {
+    state_.remaining.fetch_sub(1, std::memory_order_release);
+  }
+};
+
+using read_operation =
+    operation_t<io_uring_context::read_sender, read_receiver>;
+
+double run_benchmark(
+    std::uint32_t depth,
+    int fd,
+    std::size_t inflight,
+    std::size_t rounds,
+    bool sqpoll,
+    bool fixed,
+    bool fixedFile) {
+  io_uring_context::options opts;
+  opts.submissionQueueEntries = depth;
+  opts.completionQueueEntries = depth * 2;
+  opts.clampEntries = true;
+  opts.submissionQueuePolling = sqpoll;
+  opts.registeredBufferSlots = fixed ? 1 : 0;
+  opts.registeredFileSlots = fixedFile ? 1 : 0;
+  io_uring_context ctx{opts};
+
+  // Either the file descriptor or the index of its registered file slot.
+  const int file = fixedFile ? static_cast<int>(ctx.register_file(fd)) : fd;
+  scope_guard unregisterFile = [&]() noexcept {
+    if (fixedFile) {
+      ctx.unregister_file(static_cast<std::uint32_t>(file));
+    }
+  };
+
+  std::optional<io_uring_context::registered_buffer_pool> pool;
+  std::vector<std::byte> buffers;
+  std::vector<span<std::byte>> blocks;
+  if (fixed) {
+    pool.emplace(ctx, blockSize, inflight);
+    for (std::size_t i = 0; i < inflight; ++i) {
+      blocks.push_back(pool->allocate());
+    }
+  } else {
+    buffers.resize(inflight * blockSize);
+    for (std::size_t i = 0; i < inflight; ++i) {
+      blocks.push_back(span{buffers.data() + i * blockSize, blockSize});
+    }
+  }
+
+  inplace_stop_source stopSource;
+  std::thread ioThread{[&] { ctx.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    ioThread.join();
+  };
+
+  std::vector<manual_lifetime<read_operation>> ops(inflight);
+
+  round_state state;
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    state.remaining.store(inflight, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < inflight; ++i) {
+      ops[i].construct_from([&] {
+        return cpo::connect(
+            io_uring_context::read_sender{
+                ctx,
+                file,
+                ((round * inflight + i) % blockCount) * blockSize,
+                blocks[i],
+                fixedFile},
+            read_receiver{state});
+      });
+      cpo::start(ops[i].get());
+    }
+
+    while (state.remaining.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+
+    for (auto& op : ops) {
+      op.destruct();
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  if (state.errors.load() != 0) {
+    std::printf("warning: %zu reads failed\n", state.errors.load());
+  }
+
+  if (pool) {
+    for (auto block : blocks) {
+      pool->deallocate(block);
+    }
+  }
+
+  auto seconds = std::chrono::duration<double>(end - start).count();
+  return double(inflight * rounds) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+  bool sqpoll = false;
+  bool fixed = false;
+  bool fixedFile = false;
+  for (int i = 2; i < argc; ++i) {
+    sqpoll = sqpoll || std::strcmp(argv[i], "sqpoll") == 0;
+    fixed = fixed || std::strcmp(argv[i], "fixed") == 0;
+    fixedFile = fixedFile || std::strcmp(argv[i], "fixedfile") == 0;
+  }
+  const std::size_t inflight = 4096;
+
+  char path[] = "/tmp/io_uring_ring_depth_benchmark_XXXXXX";
+  int fd = ::mkstemp(path);
+  if (fd < 0) {
+    std::perror("mkstemp");
+    return 1;
+  }
+  scope_guard removeFile = [&]() noexcept {
+    ::close(fd);
+    ::unlink(path);
+  };
+
+  std::vector<char> block(blockSize, 'x');
+  for (std::size_t i = 0; i < blockCount; ++i) {
+    if (::write(fd, block.data(), block.size()) != ssize_t(block.size())) {
+      std::perror("write");
+      return 1;
+    }
+  }
+
+  std::printf("%8s %16s\n", "depth", "reads/sec");
+  for (std::uint32_t depth = 16; depth <= 4096; depth *= 2) {
+    double rate = run_benchmark(
+        depth, fd, inflight, rounds, sqpoll, fixed, fixedFile);
+    std::printf("%8u %16.0f\n", depth, rate);
+  }
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+using namespace std::chrono_literals;
+
+int main() {
+  io_uring_context ctx;
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  const char* path = "io_uring_scatter_gather_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  try {
+    auto file = open_file_read_write(ctx.get_scheduler(), path);
+
+    {
+      // A record assembled from a few fragments is written with one writev.
+      const char header[] = "head:";
+      const char body[] = "body:";
+      const char trailer[] = "tail\n";
+      std::vector<span<const std::byte>> fragments{
+          as_bytes(span<const char>{header, 5}),
+          as_bytes(span<const char>{body, 5}),
+          as_bytes(span<const char>{trailer, 5})};
+
+      auto bytesWritten = sync_wait(async_write_some_at(file, 0, fragments));
+      if (!bytesWritten || *bytesWritten != 15) {
+        std::printf("gather write failed\n");
+        return 1;
+      }
+
+      // And read back with one readv that scatters it across two buffers.
+      char first[7] = {};
+      char second[8] = {};
+      std::array<span<std::byte>, 2> buffers{
+          as_writable_bytes(span<char>{first, sizeof(first)}),
+          as_writable_bytes(span<char>{second, sizeof(second)})};
+
+      auto bytesRead = sync_wait(async_read_some_at(file, 0, buffers));
+      if (!bytesRead || *bytesRead != 15 ||
+          std::memcmp(first, "head:bo", 7) != 0 ||
+          std::memcmp(second, "dy:tail\n", 8) != 0) {
+        std::printf("scatter read failed\n");
+        return 1;
+      }
+    }
+
+    {
+      // Sequences longer than can be stored inline in the operation.
+      constexpr std::size_t count = 100;
+      std::vector<unsigned char> data(count);
+      std::vector<span<const std::byte>> fragments;
+      for (std::size_t i = 0; i < count; ++i) {
+        data[i] = static_cast<unsigned char>(i);
+        fragments.push_back(as_bytes(span<const unsigned char>{&data[i], 1}));
+      }
+
+      auto bytesWritten = sync_wait(async_write_some_at_until(
+          file, 0, std::move(fragments), ctx.get_scheduler().now() + 10s));
+      if (!bytesWritten || *bytesWritten != ssize_t(count)) {
+        std::printf("long gather write failed\n");
+        return 1;
+      }
+
+      std::vector<unsigned char> result(count);
+      std::vector<span<std::byte>> buffers;
+      for (std::size_t i = 0; i < count; i += 2) {
+        buffers.push_back(
+            as_writable_bytes(span<unsigned char>{&result[i], 2}));
+      }
+
+      auto bytesRead = sync_wait(async_read_some_at(file, 0, buffers));
+      if (!bytesRead || *bytesRead != ssize_t(count) || result != data) {
+        std::printf("long scatter read failed\n");
+        return 1;
+      }
+    }
+  } catch (const std::error_code& ec) {
+    std::printf("error: %s\n", ec.message().c_str());
+    return 1;
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace unifex;
+using namespace unifex::linux;
+
+static constexpr unsigned char data[6] = {'h', 'e', 'l', 'l', 'o', '\n'};
+
+int main() {
+  io_uring_context::options opts;
+  opts.submissionQueuePolling = true;
+  opts.submissionQueueThreadIdleMs = 1;
+
+  std::optional<io_uring_context> ctx;
+  try {
+    ctx.emplace(opts);
+  } catch (const std::system_error& ex) {
+    // Older kernels require elevated privileges for IORING_SETUP_SQPOLL.
+    std::printf("skipping, SQPOLL not available: %s\n", ex.what());
+    return 0;
+  }
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx->run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  const char* path = "io_uring_sqpoll_test.txt";
+  scope_guard removeFile = [&]() noexcept { ::unlink(path); };
+
+  try {
+    auto file = open_file_read_write(ctx->get_scheduler(), path);
+
+    // Sleep between some of the iterations so that the kernel polling
+    // thread goes idle and has to be woken up again.
+    for (int i = 0; i < 100; ++i) {
+      if (i % 10 == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+
+      const auto offset = i * sizeof(data);
+      auto bytesWritten =
+          sync_wait(async_write_some_at(file, offset, as_bytes(span{data})));
+      if (!bytesWritten || *bytesWritten != sizeof(data)) {
+        std::printf("write %i failed\n", i);
+        return 1;
+      }
+
+      unsigned char buffer[sizeof(data)] = {};
+      auto bytesRead = sync_wait(async_read_some_at(
+          file, offset, as_writable_bytes(span{buffer, sizeof(buffer)})));
+      if (!bytesRead || *bytesRead != sizeof(data) ||
+          std::memcmp(buffer, data, sizeof(data)) != 0) {
+        std::printf("read %i failed\n", i);
+        return 1;
+      }
+    }
+  } catch (const std::exception& ex) {
+    std::printf("error: %s\n", ex.what());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait_on.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/typed_via.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+using namespace unifex;
+using namespace unifex::linux;
+using namespace std::chrono_literals;
+
+int main() {
+  io_uring_context ctx;
+  auto scheduler = ctx.get_scheduler();
+  const auto mainThread = std::this_thread::get_id();
+
+  // Runs the ring on the calling thread, and can be called again once it's
+  // returned.
+  for (int i = 0; i < 1'000; ++i) {
+    auto result = sync_wait_on(ctx, transform(scheduler.schedule(), [&] {
+      return std::this_thread::get_id() == mainThread ? i : -1;
+    }));
+    if (result != i) {
+      std::printf("io_uring_context didn't run on the calling thread\n");
+      return 1;
+    }
+  }
+
+  // Timers need the ring to wait for the kernel.
+  auto start = scheduler.now();
+  sync_wait_on(ctx, scheduler.schedule_at(start + 10ms));
+  if (scheduler.now() - start < 10ms) {
+    std::printf("io_uring_context timer elapsed early\n");
+    return 1;
+  }
+
+  // Completes on another thread, and hops from it back onto the ring.
+  static_thread_pool pool{2};
+  for (int i = 0; i < 1'000; ++i) {
+    auto result = sync_wait_on(
+        ctx,
+        typed_via(
+            scheduler.schedule(),
+            transform(cpo::schedule(pool.get_scheduler()), [i] {
+              return i;
+            })));
+    if (result != i) {
+      std::printf("io_uring_context didn't see the result\n");
+      return 1;
+    }
+    if (!sync_wait_on(ctx, cpo::schedule(pool.get_scheduler()))) {
+      std::printf("io_uring_context didn't see the other thread complete\n");
+      return 1;
+    }
+  }
+
+  try {
+    sync_wait_on(ctx, transform(scheduler.schedule(), []() -> int {
+      throw std::runtime_error{"oops"};
+    }));
+    std::printf("io_uring_context didn't rethrow the error\n");
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+
+  inplace_stop_source stopSource;
+  stopSource.request_stop();
+  if (sync_wait_on(
+          ctx,
+          scheduler.schedule_at(scheduler.now() + 1h),
+          stopSource.get_token())) {
+    std::printf("io_uring_context didn't complete with done\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/scope_guard.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+using namespace unifex::linux;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct timer_state {
+  std::atomic<std::size_t> values{0};
+  std::atomic<std::size_t> dones{0};
+  std::atomic<std::size_t> early{0};
+};
+
+struct timer_receiver {
+  timer_state& state_;
+  io_uring_context::time_point dueTime_;
+  inplace_stop_token stopToken_;
+
+  void value() && noexcept {
+    if (monotonic_clock::now() < dueTime_) {
+      state_.early.fetch_add(1);
+    }
+    state_.values.fetch_add(1);
+  }
+
+  void done() && noexcept {
+    state_.dones.fetch_add(1);
+  }
+
+  friend inplace_stop_token tag_invoke(
+      tag_t<get_stop_token>,
+      const timer_receiver& r) noexcept {
+    return r.stopToken_;
+  }
+};
+
+using timer_operation =
+    operation_t<io_uring_context::schedule_at_sender, timer_receiver>;
+
+bool wait_for(const std::atomic<std::size_t>& count, std::size_t expected) {
+  auto start = std::chrono::steady_clock::now();
+  while (count.load() != expected) {
+    if (std::chrono::steady_clock::now() - start > 10s) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  io_uring_context::options opts;
+  opts.timerBackend = timer_backend::timing_wheel;
+  opts.timerWheelTick = 2ms;
+  io_uring_context ctx{opts};
+
+  inplace_stop_source stopSource;
+  std::thread t{[&] { ctx.run(stopSource.get_token()); }};
+  scope_guard stopOnExit = [&]() noexcept {
+    stopSource.request_stop();
+    t.join();
+  };
+
+  auto scheduler = ctx.get_scheduler();
+
+  // A single timer elapses no earlier than its due time.
+  auto start = scheduler.now();
+  sync_wait(scheduler.schedule_at(start + 20ms));
+  if (scheduler.now() - start < 20ms) {
+    std::printf("timer elapsed early\n");
+    return 1;
+  }
+
+  // Many timeouts, most of which are cancelled before they elapse.
+  constexpr std::size_t timerCount = 10'000;
+  constexpr std::size_t elapsingCount = 100;
+  timer_state state;
+  inplace_stop_source cancelSource;
+  std::vector<manual_lifetime<timer_operation>> ops(timerCount);
+
+  const auto now = scheduler.now();
+  for (std::size_t i = 0; i < timerCount; ++i) {
+    auto dueTime = i < elapsingCount
+        ? now + std::chrono::milliseconds(1 + i % 50)
+        : now + std::chrono::seconds(1 + i % 3600);
+    auto token = i < elapsingCount ? inplace_stop_token{}
+                                   : cancelSource.get_token();
+    ops[i].construct_from([&] {
+      return cpo::connect(
+          scheduler.schedule_at(dueTime),
+          timer_receiver{state, dueTime, token});
+    });
+    cpo::start(ops[i].get());
+  }
+
+  if (!wait_for(state.values, elapsingCount)) {
+    std::printf("short timers did not elapse\n");
+    return 1;
+  }
+
+  cancelSource.request_stop();
+  if (!wait_for(state.dones, timerCount - elapsingCount)) {
+    std::printf("cancelled timers did not complete\n");
+    return 1;
+  }
+
+  for (auto& op : ops) {
+    op.destruct();
+  }
+
+  if (state.early.load() != 0) {
+    std::printf("%zu timers elapsed early\n", state.early.load());
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
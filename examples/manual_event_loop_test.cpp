@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/manual_event_loop.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+int main() {
+  // Many threads hopping onto the same context at once, with the context
+  // repeatedly running out of work and going back to sleep.
+  constexpr int threadCount = 4;
+  constexpr int hopsPerThread = 10'000;
+  std::atomic<int> wrongThread = 0;
+  int count = 0;
+  {
+    single_thread_context context;
+    std::thread::id contextThread;
+    sync_wait(transform(
+        cpo::schedule(context.get_scheduler()),
+        [&] { contextThread = std::this_thread::get_id(); }));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < hopsPerThread; ++i) {
+          sync_wait(transform(cpo::schedule(context.get_scheduler()), [&] {
+            if (std::this_thread::get_id() != contextThread) {
+              ++wrongThread;
+            }
+            // Only ever touched on the context's thread.
+            ++count;
+          }));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  if (wrongThread.load() != 0 || count != threadCount * hopsPerThread) {
+    std::printf("count %i, %i on wrong thread\n", count, wrongThread.load());
+    return 1;
+  }
+
+  // A manual_event_loop runs the tasks it already has before stopping.
+  manual_event_loop loop;
+  bool ran = false;
+  std::thread producer{[&] {
+    sync_wait(transform(
+        cpo::schedule(loop.get_scheduler()), [&] { ran = true; }));
+    loop.stop();
+  }};
+  loop.run();
+  producer.join();
+  if (!ran) {
+    std::printf("task did not run\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/just.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/slab_allocator.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/via.hpp>
+#include <unifex/when_all.hpp>
+#include <unifex/with_allocator.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace unifex;
+
+int main() {
+  slab_allocator<std::byte> alloc;
+
+  // A block freed on a thread is the next one that thread allocates from
+  // the same size class.
+  std::byte* p = alloc.allocate(100);
+  alloc.deallocate(p, 100);
+  if (alloc.allocate(128) != p) {
+    std::printf("slab_allocator didn't reuse the freed block\n");
+    return 1;
+  }
+
+  // Including blocks allocated on another thread.
+  std::thread{[&] {
+    alloc.deallocate(p, 128);
+    if (alloc.allocate(65) != p) {
+      std::printf("slab_allocator didn't reuse a block from another thread\n");
+      std::exit(1);
+    }
+    alloc.deallocate(p, 65);
+  }}.join();
+
+  // Blocks that are cached on other threads, or returned to the shared pool,
+  // are never handed out twice.
+  std::vector<std::byte*> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    blocks.push_back(alloc.allocate(200));
+    *blocks.back() = static_cast<std::byte>(i);
+  }
+  std::thread{[&] {
+    for (std::byte* block : blocks) {
+      alloc.deallocate(block, 200);
+    }
+  }}.join();
+  for (int i = 0; i < 1000; ++i) {
+    blocks[i] = alloc.allocate(200);
+    *blocks[i] = static_cast<std::byte>(i);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    if (*blocks[i] != static_cast<std::byte>(i)) {
+      std::printf("slab_allocator handed out a block twice\n");
+      return 1;
+    }
+    alloc.deallocate(blocks[i], 200);
+  }
+
+  // Large allocations.
+  p = alloc.allocate(100'000);
+  alloc.deallocate(p, 100'000);
+
+  // The operation states that via() submits, allocated on this thread and
+  // freed on the context's.
+  single_thread_context context;
+  for (int i = 0; i < 1000; ++i) {
+    auto addOne = [&](int x) {
+      return transform(
+          via(cpo::schedule(context.get_scheduler()), just(x)),
+          [](int x) { return x + 1; });
+    };
+    auto result = sync_wait(
+        with_allocator(when_all(addOne(i), addOne(2 * i)), alloc));
+    auto value = [](const auto& result) {
+      return std::get<0>(std::get<0>(result));
+    };
+    if (!result || value(std::get<0>(*result)) != i + 1 ||
+        value(std::get<1>(*result)) != 2 * i + 1) {
+      std::printf("submit() with a slab_allocator didn't complete\n");
+      return 1;
+    }
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/detail/intrusive_queue.hpp>
+#include <unifex/let.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/when_all.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace unifex;
+
+// Compares static_thread_pool against a pool whose workers all take work
+// from a single mutex-protected queue, for a fan-out/fan-in workload built
+// from when_all().
+//
+// Each iteration fans out from the calling thread to 8 branches, each of
+// which hops onto the pool and fans out again to 8 leaves that each do a
+// small amount of work. The iteration completes once all 64 leaves have.
+
+namespace {
+
+class shared_queue_pool {
+  struct task_base {
+    task_base* next_ = nullptr;
+    virtual void execute() noexcept = 0;
+  };
+
+ public:
+  class scheduler {
+    class schedule_sender {
+     public:
+      template <
+          template <typename...> class Variant,
+          template <typename...> class Tuple>
+      using value_types = Variant<Tuple<>>;
+
+      template <template <typename...> class Variant>
+      using error_types = Variant<>;
+
+      template <typename Receiver>
+      class operation final : task_base {
+       public:
+        void start() noexcept {
+          pool_->enqueue(this);
+        }
+
+       private:
+        friend schedule_sender;
+
+        template <typename Receiver2>
+        explicit operation(Receiver2&& receiver, shared_queue_pool* pool)
+          : receiver_((Receiver2 &&) receiver), pool_(pool) {}
+
+        void execute() noexcept override {
+          cpo::set_value(std::move(receiver_));
+        }
+
+        Receiver receiver_;
+        shared_queue_pool* const pool_;
+      };
+
+      template <typename Receiver>
+      operation<std::remove_cvref_t<Receiver>> connect(Receiver&& receiver) && {
+        return operation<std::remove_cvref_t<Receiver>>{(Receiver &&) receiver,
+                                                        pool_};
+      }
+
+      shared_queue_pool* pool_;
+    };
+
+   public:
+    explicit scheduler(shared_queue_pool* pool) noexcept : pool_(pool) {}
+
+    schedule_sender schedule() const noexcept {
+      return schedule_sender{pool_};
+    }
+
+   private:
+    shared_queue_pool* pool_;
+  };
+
+  explicit shared_queue_pool(std::uint32_t threadCount) {
+    for (std::uint32_t i = 0; i < threadCount; ++i) {
+      threads_.emplace_back([this] { run(); });
+    }
+  }
+
+  ~shared_queue_pool() {
+    {
+      std::lock_guard lock{mutex_};
+      stop_ = true;
+      cv_.notify_all();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  scheduler get_scheduler() noexcept {
+    return scheduler{this};
+  }
+
+ private:
+  void enqueue(task_base* task) noexcept {
+    std::lock_guard lock{mutex_};
+    queue_.push_back(task);
+    cv_.notify_one();
+  }
+
+  void run() noexcept {
+    std::unique_lock lock{mutex_};
+    while (true) {
+      while (queue_.empty()) {
+        if (stop_) {
+          return;
+        }
+        cv_.wait(lock);
+      }
+      task_base* task = queue_.pop_front();
+      lock.unlock();
+      task->execute();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  intrusive_queue<task_base, &task_base::next_> queue_;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+std::atomic<std::uint64_t> sink{0};
+
+void leaf_work() {
+  std::uint64_t x = sink.load(std::memory_order_relaxed);
+  for (int i = 0; i < 200; ++i) {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+  }
+  sink.fetch_add(x & 1, std::memory_order_relaxed);
+}
+
+template <typename Scheduler>
+auto leaf(Scheduler s) {
+  return transform(cpo::schedule(s), leaf_work);
+}
+
+template <typename Scheduler>
+auto branch(Scheduler s) {
+  return let(cpo::schedule(s), [s] {
+    return when_all(
+        leaf(s), leaf(s), leaf(s), leaf(s),
+        leaf(s), leaf(s), leaf(s), leaf(s));
+  });
+}
+
+template <typename Scheduler>
+double run_benchmark(Scheduler s, int iterations) {
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    sync_wait(when_all(
+        branch(s), branch(s), branch(s), branch(s),
+        branch(s), branch(s), branch(s), branch(s)));
+  }
+  return std::chrono::duration<double, std::micro>(clock::now() - start)
+             .count() /
+      iterations;
+}
+
+} // namespace
+
+int main() {
+  constexpr int iterations = 20'000;
+  const std::uint32_t maxThreads =
+      std::max(1u, std::thread::hardware_concurrency());
+
+  for (std::uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+    double sharedQueue = 0;
+    double workStealing = 0;
+    {
+      shared_queue_pool pool{threads};
+      sharedQueue = run_benchmark(pool.get_scheduler(), iterations);
+    }
+    {
+      static_thread_pool pool{threads};
+      workStealing = run_benchmark(pool.get_scheduler(), iterations);
+    }
+    std::printf(
+        "%3u threads: shared queue %8.2f us/iteration, "
+        "work stealing %8.2f us/iteration\n",
+        threads,
+        sharedQueue,
+        workStealing);
+  }
+
+  return 0;
+}
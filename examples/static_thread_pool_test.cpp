@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/let.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/when_all.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace unifex;
+
+int main() {
+  std::set<std::thread::id> poolThreads;
+  std::mutex mutex;
+  std::atomic<int> count = 0;
+  {
+    static_thread_pool pool{4};
+    auto scheduler = pool.get_scheduler();
+
+    const auto record = [&] {
+      std::lock_guard lock{mutex};
+      poolThreads.insert(std::this_thread::get_id());
+      ++count;
+    };
+
+    // Work scheduled from outside the pool.
+    for (int i = 0; i < 100; ++i) {
+      sync_wait(transform(cpo::schedule(scheduler), record));
+    }
+
+    // Fan-out/fan-in from inside the pool, which goes through the workers'
+    // LIFO slots and deques.
+    const auto leaves = [&] {
+      return when_all(
+          transform(cpo::schedule(scheduler), record),
+          transform(cpo::schedule(scheduler), record),
+          transform(cpo::schedule(scheduler), record),
+          transform(cpo::schedule(scheduler), record));
+    };
+    const auto branch = [&] { return let(cpo::schedule(scheduler), leaves); };
+    for (int i = 0; i < 100; ++i) {
+      sync_wait(when_all(branch(), branch(), branch(), branch()));
+    }
+
+    // Many threads scheduling onto the pool at once.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < 1000; ++i) {
+          sync_wait(transform(cpo::schedule(scheduler), record));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  if (count.load() != 100 + 100 * 16 + 4 * 1000) {
+    std::printf("ran %i tasks\n", count.load());
+    return 1;
+  }
+  if (poolThreads.size() > 4 ||
+      poolThreads.count(std::this_thread::get_id()) != 0) {
+    std::printf("tasks ran on the wrong threads\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
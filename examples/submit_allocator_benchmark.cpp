@@ -0,0 +1,130 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/get_allocator.hpp>
+#include <unifex/manual_event_loop.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/single_thread_context.hpp>
+#include <unifex/slab_allocator.hpp>
+#include <unifex/submit.hpp>
+#include <unifex/sync_wait.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <experimental/memory_resource>
+#include <memory>
+
+using namespace unifex;
+
+// Measures the cost of submit()ing a sender that doesn't complete inline, so
+// that submit() allocates its operation state with the receiver's allocator:
+// - same thread:  the operations are submitted to and run by a
+//   manual_event_loop on the calling thread.
+// - cross thread: the operations are submitted from the calling thread and
+//   run, and so freed, on a single_thread_context's thread.
+//
+// The allocators are std::allocator, the default, the polymorphic_allocator
+// over new_delete_resource() that submit_allocator_customisation_test uses,
+// and slab_allocator.
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+constexpr std::size_t batch_size = 1000;
+constexpr std::size_t batch_count = 1000;
+
+template <typename Allocator>
+struct count_receiver {
+  std::size_t& count_;
+  Allocator allocator_;
+
+  void value() && noexcept {
+    ++count_;
+  }
+
+  void error(std::exception_ptr) && noexcept {
+    std::terminate();
+  }
+
+  void done() && noexcept {
+    std::terminate();
+  }
+
+  friend Allocator tag_invoke(
+      tag_t<get_allocator>,
+      const count_receiver& r) noexcept {
+    return r.allocator_;
+  }
+};
+
+template <typename Scheduler, typename Allocator, typename Wait>
+void run(
+    const char* name,
+    Scheduler scheduler,
+    const Allocator& allocator,
+    Wait wait) {
+  std::size_t count = 0;
+  auto start = clock::now();
+  for (std::size_t batch = 0; batch < batch_count; ++batch) {
+    for (std::size_t i = 0; i < batch_size; ++i) {
+      submit(
+          cpo::schedule(scheduler),
+          count_receiver<Allocator>{count, allocator});
+    }
+
+    // The loops run their work in order so this completes after all of the
+    // operations submitted before it.
+    wait(cpo::schedule(scheduler));
+  }
+  auto ns = std::chrono::duration<double, std::nano>(clock::now() - start)
+                .count() /
+      (batch_size * batch_count);
+  if (count != batch_size * batch_count) {
+    std::terminate();
+  }
+  std::printf("%-40s %6.1f ns/op\n", name, ns);
+}
+
+template <typename Allocator>
+void run_all(const char* name, const Allocator& allocator) {
+  char label[64];
+
+  manual_event_loop loop;
+  std::snprintf(label, sizeof(label), "same thread, %s", name);
+  run(label, loop.get_scheduler(), allocator, [&](auto&& sender) {
+    loop.sync_wait((decltype(sender))sender);
+  });
+
+  single_thread_context context;
+  std::snprintf(label, sizeof(label), "cross thread, %s", name);
+  run(label, context.get_scheduler(), allocator, [](auto&& sender) {
+    sync_wait((decltype(sender))sender);
+  });
+}
+
+} // namespace
+
+int main() {
+  run_all("std::allocator", std::allocator<std::byte>{});
+  run_all(
+      "new_delete_resource",
+      std::experimental::pmr::polymorphic_allocator<char>{
+          std::experimental::pmr::new_delete_resource()});
+  run_all("slab_allocator", slab_allocator<std::byte>{});
+  return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/just.hpp>
+#include <unifex/manual_event_loop.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait_on.hpp>
+#include <unifex/thread_unsafe_event_loop.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/typed_via.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+int main() {
+  manual_event_loop loop;
+  auto scheduler = loop.get_scheduler();
+  const auto mainThread = std::this_thread::get_id();
+
+  // Runs on the calling thread, and can be called again once it's returned.
+  for (int i = 0; i < 1'000; ++i) {
+    auto result = sync_wait_on(loop, transform(cpo::schedule(scheduler), [&] {
+      return std::this_thread::get_id() == mainThread ? i : -1;
+    }));
+    if (result != i) {
+      std::printf("manual_event_loop didn't run on the calling thread\n");
+      return 1;
+    }
+  }
+
+  // Completes on another thread.
+  static_thread_pool pool{2};
+  for (int i = 0; i < 1'000; ++i) {
+    auto result = sync_wait_on(
+        loop, transform(cpo::schedule(pool.get_scheduler()), [i] {
+          return i;
+        }));
+    if (result != i) {
+      std::printf("manual_event_loop didn't see the result\n");
+      return 1;
+    }
+  }
+
+  // Hops from another thread back onto the loop.
+  for (int i = 0; i < 1'000; ++i) {
+    auto result = sync_wait_on(
+        loop,
+        typed_via(
+            cpo::schedule(scheduler),
+            transform(cpo::schedule(pool.get_scheduler()), [i] {
+              return i;
+            })));
+    if (result != i) {
+      std::printf("manual_event_loop didn't see the result\n");
+      return 1;
+    }
+  }
+
+  try {
+    sync_wait_on(loop, transform(cpo::schedule(scheduler), []() -> int {
+      throw std::runtime_error{"oops"};
+    }));
+    std::printf("manual_event_loop didn't rethrow the error\n");
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+
+  inplace_stop_source stopSource;
+  stopSource.request_stop();
+  if (sync_wait_on(loop, cpo::schedule(scheduler), stopSource.get_token())) {
+    std::printf("manual_event_loop didn't complete with done\n");
+    return 1;
+  }
+
+  thread_unsafe_event_loop unsafeLoop;
+  auto start = std::chrono::steady_clock::now();
+  sync_wait_on(unsafeLoop, unsafeLoop.get_scheduler().schedule_after(10ms));
+  if (std::chrono::steady_clock::now() - start < 10ms) {
+    std::printf("thread_unsafe_event_loop timer elapsed early\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/blocking.hpp>
+#include <unifex/just.hpp>
+#include <unifex/on.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/via.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+
+using namespace unifex;
+
+int main() {
+  // Completes inline.
+  if (sync_wait(just(42)) != 42) {
+    std::printf("sync_wait() of just() didn't complete with its value\n");
+    return 1;
+  }
+
+  static_thread_pool pool{2};
+  auto scheduler = pool.get_scheduler();
+
+  // Only inline if both senders are.
+  if (cpo::blocking(on(just(), cpo::schedule(scheduler))) ==
+          blocking_kind::always_inline ||
+      cpo::blocking(via(cpo::schedule(scheduler), just())) ==
+          blocking_kind::always_inline) {
+    std::printf("on()/via() of a pool sender claim to complete inline\n");
+    return 1;
+  }
+
+  // Completes on another thread, sometimes before sync_wait() blocks and
+  // sometimes after.
+  for (int i = 0; i < 100'000; ++i) {
+    auto result = sync_wait(
+        transform(cpo::schedule(scheduler), [i] { return i; }));
+    if (result != i) {
+      std::printf("sync_wait() didn't complete with the value\n");
+      return 1;
+    }
+  }
+
+  for (int i = 0; i < 1'000; ++i) {
+    auto result = sync_wait(
+        on(just(), transform(cpo::schedule(scheduler), [i] { return i; })));
+    if (result != i) {
+      std::printf("sync_wait() of on() didn't complete with the value\n");
+      return 1;
+    }
+  }
+
+  try {
+    sync_wait(transform(cpo::schedule(scheduler), []() -> int {
+      throw std::runtime_error{"oops"};
+    }));
+    std::printf("sync_wait() didn't rethrow the error\n");
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/config.hpp>
+
+#if !UNIFEX_NO_COROUTINES
+
+#include <unifex/awaitable_sender.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/task.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+
+using namespace unifex;
+
+namespace {
+
+struct allocation_counts {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  explicit counting_allocator(allocation_counts& counts) noexcept
+    : counts_(&counts) {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other) noexcept
+    : counts_(other.counts_) {}
+
+  T* allocate(std::size_t n) {
+    ++counts_->allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    ++counts_->deallocations;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend bool operator==(counting_allocator a, counting_allocator b) noexcept {
+    return a.counts_ == b.counts_;
+  }
+
+  friend bool operator!=(counting_allocator a, counting_allocator b) noexcept {
+    return a.counts_ != b.counts_;
+  }
+
+  allocation_counts* counts_;
+};
+
+task<int> twice(int x) {
+  co_return 2 * x;
+}
+
+task<int> twice_plus_one(
+    std::allocator_arg_t,
+    counting_allocator<char>,
+    int x) {
+  co_return co_await twice(x) + 1;
+}
+
+struct multiplier {
+  int factor_;
+
+  task<int> multiply(
+      std::allocator_arg_t,
+      counting_allocator<char>,
+      int x) const {
+    co_return factor_ * x;
+  }
+};
+
+} // namespace
+
+int main() {
+  // Frames are recycled: the frame of a task that has been destroyed is
+  // reused for the next call to the same coroutine on the same thread.
+  void* frame = nullptr;
+  {
+    task<int> t = twice(1);
+    frame = t.coro_.address();
+  }
+  {
+    task<int> t = twice(2);
+    if (t.coro_.address() != frame) {
+      std::printf("task didn't reuse the coroutine frame\n");
+      return 1;
+    }
+  }
+
+  if (sync_wait(awaitable_sender{twice(21)}) != 42) {
+    std::printf("task didn't complete with its value\n");
+    return 1;
+  }
+
+  // Unless they're given an allocator.
+  allocation_counts counts;
+  counting_allocator<char> alloc{counts};
+  auto result = sync_wait(
+      awaitable_sender{twice_plus_one(std::allocator_arg, alloc, 20)});
+  if (result != 41 || counts.allocations != 1 || counts.deallocations != 1) {
+    std::printf("task didn't use the allocator\n");
+    return 1;
+  }
+
+  multiplier m{3};
+  result =
+      sync_wait(awaitable_sender{m.multiply(std::allocator_arg, alloc, 5)});
+  if (result != 15 || counts.allocations != 2 || counts.deallocations != 2) {
+    std::printf("member task didn't use the allocator\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
+
+#else // UNIFEX_NO_COROUTINES
+
+#include <cstdio>
+
+int main() {
+  std::printf(
+      "This test only supported for compilers that support coroutines\n");
+  return 0;
+}
+
+#endif // UNIFEX_NO_COROUTINES
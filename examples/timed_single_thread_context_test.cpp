@@ -0,0 +1,175 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/timer_backend.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+struct timer_state {
+  std::atomic<std::size_t> values{0};
+  std::atomic<std::size_t> dones{0};
+  std::atomic<std::size_t> early{0};
+};
+
+struct timer_receiver {
+  timer_state& state_;
+  clock_type::time_point dueTime_;
+  inplace_stop_token stopToken_;
+
+  void value() && noexcept {
+    if (clock_type::now() < dueTime_) {
+      state_.early.fetch_add(1);
+    }
+    state_.values.fetch_add(1);
+  }
+
+  void error(std::exception_ptr) && noexcept {}
+
+  void done() && noexcept {
+    state_.dones.fetch_add(1);
+  }
+
+  friend inplace_stop_token tag_invoke(
+      tag_t<get_stop_token>,
+      const timer_receiver& r) noexcept {
+    return r.stopToken_;
+  }
+};
+
+using timer_operation = operation_t<
+    decltype(std::declval<timed_single_thread_context::scheduler&>()
+                 .schedule_at(clock_type::time_point{})),
+    timer_receiver>;
+
+bool wait_for(const std::atomic<std::size_t>& count, std::size_t expected) {
+  auto start = clock_type::now();
+  while (count.load() != expected) {
+    if (clock_type::now() - start > 10s) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+// Several threads schedule timers at once. Each cancels every other timer it
+// started, some racing with the timer elapsing and some long before.
+bool test_concurrent_timers(timer_backend backend) {
+  timed_single_thread_context context{backend};
+  auto scheduler = context.get_scheduler();
+
+  constexpr std::size_t threadCount = 4;
+  constexpr std::size_t timersPerThread = 2'000;
+  timer_state state;
+  std::vector<std::vector<manual_lifetime<timer_operation>>> ops(threadCount);
+  std::vector<std::vector<inplace_stop_source>> stopSources(threadCount);
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < threadCount; ++t) {
+    ops[t] = std::vector<manual_lifetime<timer_operation>>(timersPerThread);
+    stopSources[t] = std::vector<inplace_stop_source>(timersPerThread);
+    threads.emplace_back([&, t] {
+      for (std::size_t i = 0; i < timersPerThread; ++i) {
+        const bool shortTimer = i % 4 < 2;
+        const auto dueTime = clock_type::now() +
+            (shortTimer ? std::chrono::microseconds(i % 1000) : 1h);
+        ops[t][i].construct_from([&] {
+          return cpo::connect(
+              scheduler.schedule_at(dueTime),
+              timer_receiver{state, dueTime, stopSources[t][i].get_token()});
+        });
+        cpo::start(ops[t][i].get());
+        if (i % 2 == 1) {
+          stopSources[t][i].request_stop();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Half of the timers are cancelled, of which half are short timers that
+  // may have elapsed first. The rest are short timers that must elapse and
+  // long timers that are still pending.
+  constexpr std::size_t total = threadCount * timersPerThread;
+  const auto completed = [&] {
+    return state.values.load() + state.dones.load();
+  };
+  auto start = clock_type::now();
+  while (completed() != total * 3 / 4) {
+    if (clock_type::now() - start > 10s) {
+      std::printf("timers did not complete\n");
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  if (state.values.load() < total / 4) {
+    std::printf("short timers did not elapse\n");
+    return false;
+  }
+
+  // Now cancel the remaining long timers from this thread.
+  for (auto& sources : stopSources) {
+    for (auto& source : sources) {
+      source.request_stop();
+    }
+  }
+  if (!wait_for(state.dones, total - state.values.load())) {
+    std::printf("cancelled timers did not complete\n");
+    return false;
+  }
+
+  for (auto& threadOps : ops) {
+    for (auto& op : threadOps) {
+      op.destruct();
+    }
+  }
+
+  if (state.early.load() != 0) {
+    std::printf("%zu timers elapsed early\n", state.early.load());
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  if (!test_concurrent_timers(timer_backend::priority_queue) ||
+      !test_concurrent_timers(timer_backend::timing_wheel)) {
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/thread_unsafe_event_loop.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/timer_backend.hpp>
+#include <unifex/transform.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <thread>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+struct cancel_receiver {
+  std::atomic<bool>& done_;
+  inplace_stop_token stopToken_;
+
+  void value() && noexcept {}
+
+  void error(std::exception_ptr) && noexcept {}
+
+  void done() && noexcept {
+    done_.store(true);
+  }
+
+  friend inplace_stop_token tag_invoke(
+      tag_t<get_stop_token>,
+      const cancel_receiver& r) noexcept {
+    return r.stopToken_;
+  }
+};
+
+bool test_timed_single_thread_context() {
+  timed_single_thread_context context{timer_backend::timing_wheel, 1ms};
+  auto scheduler = context.get_scheduler();
+
+  // Timers never elapse early.
+  auto start = clock_type::now();
+  sync_wait(scheduler.schedule_after(20ms));
+  if (clock_type::now() - start < 20ms) {
+    std::printf("timed_single_thread_context: timer elapsed early\n");
+    return false;
+  }
+
+  // Work that is already due doesn't wait for the next tick.
+  sync_wait(scheduler.schedule());
+  sync_wait(scheduler.schedule_at(clock_type::now() - 1s));
+
+  // Cancelling a timer that is far in the future completes it promptly.
+  std::atomic<bool> done = false;
+  inplace_stop_source stopSource;
+  auto op = cpo::connect(
+      scheduler.schedule_after(1h),
+      cancel_receiver{done, stopSource.get_token()});
+  cpo::start(op);
+  std::this_thread::sleep_for(5ms);
+  start = clock_type::now();
+  stopSource.request_stop();
+  while (!done.load() && clock_type::now() - start < 5s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  if (!done.load()) {
+    std::printf("timed_single_thread_context: cancellation failed\n");
+    return false;
+  }
+
+  return true;
+}
+
+bool test_thread_unsafe_event_loop() {
+  thread_unsafe_event_loop loop{timer_backend::timing_wheel, 1ms};
+  auto scheduler = loop.get_scheduler();
+
+  auto start = clock_type::now();
+  loop.sync_wait(scheduler.schedule_after(20ms));
+  if (clock_type::now() - start < 20ms) {
+    std::printf("thread_unsafe_event_loop: timer elapsed early\n");
+    return false;
+  }
+
+  loop.sync_wait(scheduler.schedule());
+
+  // A timer that is cancelled before it starts completes immediately.
+  inplace_stop_source stopSource;
+  stopSource.request_stop();
+  if (loop.sync_wait(scheduler.schedule_after(1h), stopSource.get_token())) {
+    std::printf("thread_unsafe_event_loop: stopped timer produced a value\n");
+    return false;
+  }
+
+  // A timer that is cancelled while it is in the wheel completes
+  // immediately.
+  std::atomic<bool> done = false;
+  inplace_stop_source stopSource2;
+  auto op = cpo::connect(
+      scheduler.schedule_after(1h),
+      cancel_receiver{done, stopSource2.get_token()});
+  cpo::start(op);
+  start = clock_type::now();
+  loop.sync_wait(transform(
+      scheduler.schedule_after(5ms), [&] { stopSource2.request_stop(); }));
+  if (!done.load() || clock_type::now() - start > 1s) {
+    std::printf("thread_unsafe_event_loop: cancellation failed\n");
+    return false;
+  }
+
+  return true;
+}
+
+// Ticks of zero or less are rounded up rather than dividing by zero.
+bool test_zero_tick() {
+  {
+    timed_single_thread_context context{timer_backend::timing_wheel, 0ns};
+    sync_wait(context.get_scheduler().schedule_after(1ms));
+  }
+  {
+    thread_unsafe_event_loop loop{timer_backend::timing_wheel, -1ms};
+    loop.sync_wait(loop.get_scheduler().schedule_after(1ms));
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  if (!test_timed_single_thread_context() || !test_thread_unsafe_event_loop() ||
+      !test_zero_tick()) {
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/range_stream.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stream_concepts.hpp>
+#include <unifex/type_erased_stream.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <utility>
+
+using namespace unifex;
+
+// Measures the overhead of type_erased_stream:
+// - per element: pulling each element of a range_stream through next(),
+//   directly and through a type_erased_stream.
+// - per stream:  creating, pulling one element from and destroying a
+//   type_erased_stream, stored inline and allocated.
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+double nanoseconds_per_item(clock::time_point start, std::size_t count) {
+  return std::chrono::duration<double, std::nano>(clock::now() - start)
+             .count() /
+      count;
+}
+
+struct sum_receiver {
+  std::int64_t& sum_;
+  bool& done_;
+
+  void value(int value) && noexcept {
+    sum_ += value;
+  }
+
+  void done() && noexcept {
+    done_ = true;
+  }
+
+  void error(std::exception_ptr) && noexcept {
+    std::terminate();
+  }
+};
+
+// Pulls elements from the stream in a loop until it's done, as reduce
+// streams recurse for streams that complete inline.
+template <typename Stream>
+std::int64_t sum(Stream& stream) {
+  std::int64_t sum = 0;
+  bool done = false;
+  while (!done) {
+    auto op = cpo::connect(cpo::next(stream), sum_receiver{sum, done});
+    cpo::start(op);
+  }
+  // Both streams' cleanup() completes inline.
+  auto op = cpo::connect(cpo::cleanup(stream), sum_receiver{sum, done});
+  cpo::start(op);
+  return sum;
+}
+
+template <std::size_t InlineSize>
+std::int64_t create_and_pull(std::size_t count) {
+  std::int64_t total = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    basic_type_erased_stream<InlineSize, int> stream{range_stream{1, 2}};
+    total += sum(stream);
+  }
+  return total;
+}
+
+} // namespace
+
+int main() {
+  constexpr std::size_t elementCount = 10'000'000;
+  constexpr int max = static_cast<int>(elementCount);
+
+  auto start = clock::now();
+  range_stream direct{max};
+  std::int64_t total = sum(direct);
+  const double directCost = nanoseconds_per_item(start, elementCount);
+
+  start = clock::now();
+  auto erased = type_erase<int>(range_stream{max});
+  total += sum(erased);
+  const double erasedCost = nanoseconds_per_item(start, elementCount);
+
+  std::printf(
+      "per element: direct %.2f ns, type-erased %.2f ns\n",
+      directCost,
+      erasedCost);
+
+  constexpr std::size_t streamCount = 1'000'000;
+
+  start = clock::now();
+  total += create_and_pull<type_erased_stream_default_inline_size>(
+      streamCount);
+  const double inlineCost = nanoseconds_per_item(start, streamCount);
+
+  start = clock::now();
+  total += create_and_pull<0>(streamCount);
+  const double allocatedCost = nanoseconds_per_item(start, streamCount);
+
+  std::printf(
+      "per stream: inline %.2f ns, allocated %.2f ns\n",
+      inlineCost,
+      allocatedCost);
+
+  // Stop the work being optimised away.
+  if (total == 0) {
+    std::printf("no elements\n");
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/for_each.hpp>
+#include <unifex/range_stream.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform_stream.hpp>
+#include <unifex/type_erased_stream.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+using namespace unifex;
+
+namespace {
+
+struct allocation_counts {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  explicit counting_allocator(allocation_counts& counts) noexcept
+    : counts_(&counts) {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other) noexcept
+    : counts_(other.counts_) {}
+
+  T* allocate(std::size_t n) {
+    ++counts_->allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    ++counts_->deallocations;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend bool operator==(counting_allocator a, counting_allocator b) noexcept {
+    return a.counts_ == b.counts_;
+  }
+
+  friend bool operator!=(counting_allocator a, counting_allocator b) noexcept {
+    return a.counts_ != b.counts_;
+  }
+
+  allocation_counts* counts_;
+};
+
+// A range_stream too big to be stored inline.
+struct big_range_stream : range_stream {
+  explicit big_range_stream(int max) : range_stream(max) {}
+
+  std::array<std::byte, 2 * type_erased_stream_default_inline_size> padding_{};
+};
+
+template <typename Stream>
+int sum(Stream&& stream) {
+  int total = 0;
+  sync_wait(cpo::for_each((Stream &&) stream, [&](int value) {
+    total += value;
+  }));
+  return total;
+}
+
+} // namespace
+
+int main() {
+  allocation_counts counts;
+  counting_allocator<char> alloc{counts};
+
+  // Small streams are stored inline, and can be moved before they're used.
+  {
+    auto stream = type_erase<int>(
+        transform_stream(range_stream{10}, [](int x) { return x * 2; }),
+        alloc);
+    auto moved = std::move(stream);
+    if (sum(std::move(moved)) != 90 || counts.allocations != 0) {
+      std::printf("inline stream failed\n");
+      return 1;
+    }
+  }
+
+  // Big ones are allocated with the allocator.
+  {
+    auto stream = type_erase<int>(big_range_stream{10}, alloc);
+    auto moved = std::move(stream);
+    if (sum(std::move(moved)) != 45 || counts.allocations != 1) {
+      std::printf("allocated stream failed\n");
+      return 1;
+    }
+  }
+  if (counts.deallocations != 1) {
+    std::printf("allocated stream wasn't deallocated\n");
+    return 1;
+  }
+
+  // The inline size is configurable.
+  {
+    basic_type_erased_stream<0, int> stream{
+        std::allocator_arg, alloc, range_stream{10}};
+    if (sum(std::move(stream)) != 45 || counts.allocations != 2) {
+      std::printf("stream with no inline storage failed\n");
+      return 1;
+    }
+  }
+  if (counts.deallocations != 2) {
+    std::printf("stream with no inline storage wasn't deallocated\n");
+    return 1;
+  }
+
+  // Without an allocator.
+  if (sum(type_erase<int>(range_stream{5})) != 10 ||
+      sum(type_erase<int>(big_range_stream{5})) != 10) {
+    std::printf("stream without an allocator failed\n");
+    return 1;
+  }
+
+  std::printf("success\n");
+  return 0;
+}
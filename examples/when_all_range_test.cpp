@@ -0,0 +1,248 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/just.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/when_all_range.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+using namespace unifex;
+
+namespace {
+
+struct counters {
+  std::atomic<int> outstanding{0};
+  std::atomic<int> maxOutstanding{0};
+  std::atomic<int> started{0};
+};
+
+// Wraps a sender to count how many operations are outstanding at once.
+template <typename Inner>
+struct counted_sender {
+  Inner inner_;
+  counters* counters_;
+
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = typename Inner::template value_types<Variant, Tuple>;
+
+  template <template <typename...> class Variant>
+  using error_types = typename Inner::template error_types<Variant>;
+
+  template <typename Receiver>
+  struct receiver {
+    Receiver receiver_;
+    counters* counters_;
+
+    template <typename... Values>
+    void value(Values&&... values) && {
+      --counters_->outstanding;
+      cpo::set_value(std::move(receiver_), (Values &&) values...);
+    }
+
+    template <typename Error>
+    void error(Error&& error) && noexcept {
+      --counters_->outstanding;
+      cpo::set_error(std::move(receiver_), (Error &&) error);
+    }
+
+    void done() && noexcept {
+      --counters_->outstanding;
+      cpo::set_done(std::move(receiver_));
+    }
+  };
+
+  template <typename Receiver>
+  struct operation {
+    operation_t<Inner, receiver<Receiver>> inner_;
+    counters* counters_;
+
+    void start() noexcept {
+      ++counters_->started;
+      const int outstanding = ++counters_->outstanding;
+      int max = counters_->maxOutstanding.load();
+      while (outstanding > max &&
+             !counters_->maxOutstanding.compare_exchange_weak(
+                 max, outstanding)) {
+      }
+      cpo::start(inner_);
+    }
+  };
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) && {
+    return operation<std::remove_cvref_t<Receiver>>{
+        cpo::connect(
+            std::move(inner_),
+            receiver<std::remove_cvref_t<Receiver>>{(Receiver &&) r,
+                                                    counters_}),
+        counters_};
+  }
+};
+
+template <typename Inner>
+counted_sender<Inner> counted(Inner inner, counters& c) {
+  return counted_sender<Inner>{std::move(inner), &c};
+}
+
+struct no_default {
+  explicit no_default(int value) : value_(value) {}
+  int value_;
+};
+
+} // namespace
+
+int main() {
+  // Many senders that complete synchronously, unbounded.
+  {
+    std::vector<decltype(just(0))> senders;
+    for (int i = 0; i < 10'000; ++i) {
+      senders.push_back(just(i));
+    }
+    auto result = sync_wait(when_all_range(std::move(senders)));
+    if (!result || result->size() != 10'000 || (*result)[1234] != 1234) {
+      std::printf("synchronous senders failed\n");
+      return 1;
+    }
+  }
+
+  // Bounded concurrency on a thread pool.
+  {
+    static_thread_pool pool{4};
+    auto scheduler = pool.get_scheduler();
+    counters c;
+    auto make = [&](int i) {
+      return counted(transform(cpo::schedule(scheduler), [i] { return i; }), c);
+    };
+    std::vector<decltype(make(0))> senders;
+    for (int i = 0; i < 1000; ++i) {
+      senders.push_back(make(i));
+    }
+    auto result = sync_wait(when_all_range(std::move(senders), 3));
+    if (!result || result->size() != 1000) {
+      std::printf("pool senders failed\n");
+      return 1;
+    }
+    for (int i = 0; i < 1000; ++i) {
+      if ((*result)[i] != i) {
+        std::printf("result %i is out of order\n", i);
+        return 1;
+      }
+    }
+    if (c.maxOutstanding.load() > 3 || c.started.load() != 1000) {
+      std::printf(
+          "%i outstanding at once, %i started\n",
+          c.maxOutstanding.load(),
+          c.started.load());
+      return 1;
+    }
+
+    // bool results are written from several threads at once.
+    auto makeBool = [&](int i) {
+      return transform(cpo::schedule(scheduler), [i] { return i % 3 == 0; });
+    };
+    std::vector<decltype(makeBool(0))> boolSenders;
+    for (int i = 0; i < 1000; ++i) {
+      boolSenders.push_back(makeBool(i));
+    }
+    auto bools = sync_wait(when_all_range(std::move(boolSenders), 8));
+    if (!bools || bools->size() != 1000) {
+      std::printf("bool senders failed\n");
+      return 1;
+    }
+    for (int i = 0; i < 1000; ++i) {
+      if ((*bools)[i] != (i % 3 == 0)) {
+        std::printf("bool result %i is wrong\n", i);
+        return 1;
+      }
+    }
+
+    // Senders with no values.
+    std::vector<decltype(cpo::schedule(scheduler))> voidSenders(
+        100, cpo::schedule(scheduler));
+    if (!sync_wait(when_all_range(std::move(voidSenders), 8))) {
+      std::printf("void senders failed\n");
+      return 1;
+    }
+  }
+
+  // Results that can't be default-constructed.
+  {
+    auto make = [](int i) {
+      return transform(just(i), [](int i) { return no_default{i}; });
+    };
+    std::vector<decltype(make(0))> senders;
+    for (int i = 0; i < 10; ++i) {
+      senders.push_back(make(i));
+    }
+    auto result = sync_wait(when_all_range(std::move(senders), 2));
+    if (!result || result->size() != 10 || (*result)[9].value_ != 9) {
+      std::printf("non-default-constructible results failed\n");
+      return 1;
+    }
+  }
+
+  // An error stops any more senders from starting.
+  {
+    counters c;
+    auto make = [&](int i) {
+      return counted(
+          transform(
+              just(i),
+              [](int i) {
+                if (i == 5) {
+                  throw std::runtime_error("failed");
+                }
+                return i;
+              }),
+          c);
+    };
+    std::vector<decltype(make(0))> senders;
+    for (int i = 0; i < 100; ++i) {
+      senders.push_back(make(i));
+    }
+    try {
+      sync_wait(when_all_range(std::move(senders), 1));
+      std::printf("error was not propagated\n");
+      return 1;
+    } catch (const std::runtime_error&) {
+    }
+    if (c.started.load() != 6) {
+      std::printf("%i senders started after an error\n", c.started.load());
+      return 1;
+    }
+  }
+
+  // No senders at all.
+  {
+    auto result = sync_wait(when_all_range(std::vector<decltype(just(0))>{}));
+    if (!result || !result->empty()) {
+      std::printf("empty range failed\n");
+      return 1;
+    }
+  }
+
+  std::printf("success\n");
+  return 0;
+}
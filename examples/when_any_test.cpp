@@ -0,0 +1,295 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/just.hpp>
+#include <unifex/ready_done_sender.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/tag_invoke.hpp>
+#include <unifex/timed_single_thread_context.hpp>
+#include <unifex/transform.hpp>
+#include <unifex/when_any.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace unifex;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A query that only answering_receiver answers.
+inline constexpr struct get_answer_cpo {
+  template <typename Receiver>
+  auto operator()(const Receiver& r) const noexcept
+      -> tag_invoke_result_t<get_answer_cpo, const Receiver&> {
+    return tag_invoke(*this, r);
+  }
+} get_answer{};
+
+struct answering_receiver {
+  const int* answer_;
+  std::optional<int>* result_;
+  std::atomic<bool>* completed_;
+
+  void value(int value) && noexcept {
+    *result_ = value;
+    completed_->store(true);
+  }
+
+  void error(std::exception_ptr) && noexcept {
+    completed_->store(true);
+  }
+
+  void done() && noexcept {
+    completed_->store(true);
+  }
+
+  friend int tag_invoke(
+      tag_t<get_answer>,
+      const answering_receiver& r) noexcept {
+    return *r.answer_;
+  }
+};
+
+// What a loser of when_any_range() could query of its receiver.
+struct late_query_result {
+  bool answerForwarded = false;
+  bool stopRequested = false;
+};
+
+using pool_scheduler =
+    decltype(std::declval<static_thread_pool&>().get_scheduler());
+
+template <typename Receiver>
+struct late_query_operation;
+
+// Completes with 'value_' on a thread pool, regardless of stop requests. If
+// 'release_' is set then it first waits for it and then records what it can
+// still query of its receiver.
+struct late_query_sender {
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<int>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  pool_scheduler scheduler_;
+  int value_;
+  std::atomic<bool>* release_;
+  late_query_result* result_;
+
+  template <typename Receiver>
+  late_query_operation<std::remove_cvref_t<Receiver>> connect(
+      Receiver&& receiver) && {
+    return late_query_operation<std::remove_cvref_t<Receiver>>{
+        (Receiver &&) receiver, *this};
+  }
+};
+
+template <typename Receiver>
+struct late_query_operation {
+  struct resume_receiver {
+    late_query_operation& op_;
+
+    void value() && noexcept {
+      op_.resume();
+    }
+
+    void error(std::exception_ptr) && noexcept {
+      std::terminate();
+    }
+
+    void done() && noexcept {
+      op_.resume();
+    }
+  };
+
+  template <typename Receiver2>
+  explicit late_query_operation(
+      Receiver2&& receiver,
+      const late_query_sender& sender)
+    : receiver_((Receiver2 &&) receiver),
+      sender_(sender),
+      inner_(cpo::connect(
+          cpo::schedule(sender.scheduler_), resume_receiver{*this})) {}
+
+  void start() noexcept {
+    cpo::start(inner_);
+  }
+
+  void resume() noexcept {
+    if (sender_.release_ != nullptr) {
+      while (!sender_.release_->load()) {
+        std::this_thread::yield();
+      }
+      sender_.result_->answerForwarded =
+          std::is_invocable_v<tag_t<get_answer>, const Receiver&>;
+      sender_.result_->stopRequested =
+          get_stop_token(receiver_).stop_requested();
+    }
+    cpo::set_value(std::move(receiver_), sender_.value_);
+  }
+
+  Receiver receiver_;
+  late_query_sender sender_;
+  operation_t<
+      decltype(cpo::schedule(std::declval<pool_scheduler&>())),
+      resume_receiver>
+      inner_;
+};
+
+} // namespace
+
+int main() {
+  timed_single_thread_context context;
+  auto scheduler = context.get_scheduler();
+
+  auto after = [&](std::chrono::milliseconds delay, int value) {
+    return transform(
+        cpo::schedule_after(scheduler, delay), [value] { return value; });
+  };
+
+  // The first sender to complete wins and the loser is cancelled rather
+  // than left to run for an hour.
+  auto start = std::chrono::steady_clock::now();
+  std::optional<int> result = sync_wait(when_any(after(1h, 1), after(10ms, 2)));
+  if (result != 2 || std::chrono::steady_clock::now() - start > 10s) {
+    std::printf("when_any() didn't complete with the first result\n");
+    return 1;
+  }
+
+  // An error wins too.
+  try {
+    sync_wait(when_any(
+        after(1h, 1),
+        transform(just(), []() -> int { throw std::runtime_error{"oops"}; })));
+    std::printf("when_any() didn't complete with the error\n");
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+
+  // Senders that complete with done don't win.
+  result = sync_wait(when_any(ready_done_sender{}, after(10ms, 3)));
+  if (result != 3) {
+    std::printf("when_any() didn't skip the sender that was done\n");
+    return 1;
+  }
+
+  // Done if the receiver asks it to stop, as then all of them are done.
+  inplace_stop_source stopSource;
+  stopSource.request_stop();
+  if (sync_wait(when_any(after(1h, 1), after(1h, 2)), stopSource.get_token())) {
+    std::printf("when_any() didn't stop\n");
+    return 1;
+  }
+
+  // A runtime-sized number of senders.
+  std::vector<decltype(after(1h, 0))> senders;
+  for (int i = 0; i < 10; ++i) {
+    senders.push_back(after(i == 7 ? 10ms : 1h, i));
+  }
+  start = std::chrono::steady_clock::now();
+  result = sync_wait(when_any_range(std::move(senders)));
+  if (result != 7 || std::chrono::steady_clock::now() - start > 10s) {
+    std::printf("when_any_range() didn't complete with the first result\n");
+    return 1;
+  }
+
+  if (sync_wait(when_any_range(std::vector<decltype(after(1h, 0))>{}))) {
+    std::printf("when_any_range() of nothing didn't complete with done\n");
+    return 1;
+  }
+
+  // The winner of when_any_range() is passed on without waiting for a loser
+  // that doesn't respond to the stop request.
+  {
+    static_thread_pool pool{2};
+    std::atomic<bool> release{false};
+    std::atomic<bool> loserTimedOut{false};
+    auto make = [&](int i) {
+      return transform(cpo::schedule(pool.get_scheduler()), [&, i] {
+        if (i == 0) {
+          auto deadline = std::chrono::steady_clock::now() + 10s;
+          while (!release.load()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+              loserTimedOut = true;
+              break;
+            }
+            std::this_thread::sleep_for(1ms);
+          }
+        }
+        return i;
+      });
+    };
+    std::vector<decltype(make(0))> slowSenders;
+    slowSenders.push_back(make(0));
+    slowSenders.push_back(make(1));
+    result = sync_wait(when_any_range(std::move(slowSenders)));
+    release = true;
+    if (result != 1 || loserTimedOut.load()) {
+      std::printf("when_any_range() waited for the loser\n");
+      return 1;
+    }
+  }
+
+  // A loser of when_any_range() that carries on after the winner has
+  // completed the receiver can't reach it, only its stop token.
+  {
+    late_query_result queried;
+    std::atomic<bool> release{false};
+    std::atomic<bool> completed{false};
+    std::optional<int> answerResult;
+    {
+      static_thread_pool pool{2};
+      auto make = [&](int i) {
+        return late_query_sender{
+            pool.get_scheduler(), i, i == 0 ? &release : nullptr, &queried};
+      };
+      std::vector<late_query_sender> querySenders{make(0), make(1)};
+      {
+        const int answer = 42;
+        auto op = cpo::connect(
+            when_any_range(std::move(querySenders)),
+            answering_receiver{&answer, &answerResult, &completed});
+        cpo::start(op);
+        while (!completed.load()) {
+          std::this_thread::yield();
+        }
+      }
+
+      // The operation and the answer have gone. Let the loser query.
+      release = true;
+    }
+    if (answerResult != 1 || queried.answerForwarded ||
+        !queried.stopRequested) {
+      std::printf("when_any_range() loser reached the completed receiver\n");
+      return 1;
+    }
+  }
+
+  std::printf("success\n");
+  return 0;
+}
@@ -0,0 +1,366 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/any_unique.hpp>
+#include <unifex/async_trace.hpp>
+#include <unifex/config.hpp>
+#include <unifex/get_allocator.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
+#include <unifex/tag_invoke.hpp>
+#include <unifex/this.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace unifex {
+
+// Operation states that take up no more than this many bytes, once
+// type-erased, are stored inline in an any_sender_of's operation rather than
+// allocated.
+inline constexpr std::size_t any_sender_of_default_inline_size = 64;
+
+// Concrete senders that take up no more than this many bytes, and are nothrow
+// move-constructible, are stored inline in an any_sender_of rather than
+// allocated.
+inline constexpr std::size_t any_sender_of_sender_inline_size =
+    4 * sizeof(void*);
+
+namespace detail {
+
+template <typename... Values>
+struct any_sender_of_impl {
+  // The receiver that the type-erased operation completes to.
+  struct receiver_base {
+    virtual void value(Values&&... values) noexcept = 0;
+    virtual void error(std::exception_ptr ex) noexcept = 0;
+    virtual void done() noexcept = 0;
+
+    // Storage for operations that don't fit inline, from the receiver's
+    // allocator.
+    virtual void* allocate(std::size_t size) = 0;
+    virtual void deallocate(void* p, std::size_t size) noexcept = 0;
+
+    virtual inplace_stop_token stop_token() noexcept = 0;
+
+    virtual continuation_info get_continuation_info() const noexcept = 0;
+
+   protected:
+    ~receiver_base() = default;
+  };
+
+  struct operation_base {
+    virtual void start() noexcept = 0;
+
+    // Destroy the operation and free its storage, if it was allocated.
+    virtual void destroy(receiver_base& receiver) noexcept = 0;
+
+   protected:
+    ~operation_base() = default;
+  };
+
+  struct receiver_wrapper {
+    receiver_base& receiver_;
+
+    template <typename... Values2>
+    void value(Values2&&... values) && noexcept {
+      if constexpr (std::conjunction_v<
+                        std::is_same<Values2&&, Values&&>...>) {
+        receiver_.value((Values &&) values...);
+      } else {
+        try {
+          [&](Values... values) {
+            receiver_.value((Values &&) values...);
+          }((Values2 &&) values...);
+        } catch (...) {
+          receiver_.error(std::current_exception());
+        }
+      }
+    }
+
+    void error(std::exception_ptr ex) && noexcept {
+      receiver_.error(std::move(ex));
+    }
+
+    template <typename Error>
+    void error(Error&& error) && noexcept {
+      // Type-erase any errors that come through.
+      std::move(*this).error(std::make_exception_ptr((Error &&) error));
+    }
+
+    void done() && noexcept {
+      receiver_.done();
+    }
+
+    friend inplace_stop_token tag_invoke(
+        tag_t<get_stop_token>,
+        const receiver_wrapper& r) noexcept {
+      return r.receiver_.stop_token();
+    }
+
+    template <typename Func>
+    friend void tag_invoke(
+        tag_t<visit_continuations>,
+        const receiver_wrapper& r,
+        Func&& func) {
+      visit_continuations(r.receiver_.get_continuation_info(), (Func &&) func);
+    }
+  };
+
+  template <typename Sender, bool Allocated>
+  struct concrete_operation final : operation_base {
+    explicit concrete_operation(Sender&& sender, receiver_base& receiver)
+      : op_(cpo::connect((Sender &&) sender, receiver_wrapper{receiver})) {}
+
+    void start() noexcept override {
+      cpo::start(op_);
+    }
+
+    void destroy(receiver_base& receiver) noexcept override {
+      this->~concrete_operation();
+      if constexpr (Allocated) {
+        receiver.deallocate(this, sizeof(concrete_operation));
+      } else {
+        (void)receiver;
+      }
+    }
+
+    operation_t<Sender, receiver_wrapper> op_;
+  };
+
+  // Connect the type-erased sender to 'receiver', placing the operation in
+  // 'buffer' if it fits in 'bufferSize' bytes or else in storage from the
+  // receiver.
+  struct connect_cpo {
+    using type_erased_signature_t =
+        operation_base*(this_&&, receiver_base&, void*, std::size_t);
+
+    template <typename Sender>
+    operation_base* operator()(
+        Sender&& sender,
+        receiver_base& receiver,
+        void* buffer,
+        std::size_t bufferSize) const {
+      if constexpr (is_tag_invocable_v<
+                        connect_cpo,
+                        Sender,
+                        receiver_base&,
+                        void*,
+                        std::size_t>) {
+        return tag_invoke(
+            connect_cpo{}, (Sender &&) sender, receiver, buffer, bufferSize);
+      } else {
+        using sender_type = std::remove_cvref_t<Sender>;
+        using inline_operation = concrete_operation<sender_type, false>;
+        using allocated_operation = concrete_operation<sender_type, true>;
+        static_assert(
+            alignof(allocated_operation) <= alignof(std::max_align_t),
+            "over-aligned operation states aren't supported");
+
+        if (sizeof(inline_operation) <= bufferSize) {
+          return ::new (buffer) inline_operation{(Sender &&) sender, receiver};
+        }
+
+        void* storage = receiver.allocate(sizeof(allocated_operation));
+        try {
+          return ::new (storage)
+              allocated_operation{(Sender &&) sender, receiver};
+        } catch (...) {
+          receiver.deallocate(storage, sizeof(allocated_operation));
+          throw;
+        }
+      }
+    }
+  };
+};
+
+} // namespace detail
+
+// A type-erased sender that completes with a value pack of type (Values...,),
+// or with an error of type std::exception_ptr, or with done.
+//
+// The concrete sender is stored inline if it fits in
+// any_sender_of_sender_inline_size bytes and is allocated otherwise. When
+// connected, the concrete operation state is stored inline in the returned
+// operation if it fits in 'InlineSize' bytes. Otherwise it is allocated using
+// the receiver's allocator, see get_allocator().
+template <std::size_t InlineSize, typename... Values>
+class basic_any_sender_of {
+  using impl = detail::any_sender_of_impl<Values...>;
+  using receiver_base = typename impl::receiver_base;
+  using operation_base = typename impl::operation_base;
+  using connect_cpo = typename impl::connect_cpo;
+
+  template <typename Receiver>
+  class operation final : receiver_base {
+    using stop_token_type = stop_token_type_t<Receiver&>;
+
+    struct cancel_operation {
+      operation& op_;
+
+      void operator()() noexcept {
+        op_.stopState_.stopSource_.request_stop();
+      }
+    };
+
+    // Receivers with an inplace_stop_token, or one that can never stop, can
+    // have it passed straight through.
+    static constexpr bool adapt_stop_token =
+        !std::is_same_v<stop_token_type, inplace_stop_token> &&
+        !is_stop_never_possible_v<stop_token_type>;
+
+    struct stop_state {
+      inplace_stop_source stopSource_;
+      manual_lifetime<
+          typename stop_token_type::template callback_type<cancel_operation>>
+          stopCallback_;
+    };
+
+    struct no_stop_state {};
+
+    using allocator_type =
+        typename std::allocator_traits<std::remove_cvref_t<get_allocator_t<
+            const Receiver&>>>::template rebind_alloc<std::max_align_t>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    static std::size_t allocation_count(std::size_t size) noexcept {
+      return (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    }
+
+   public:
+    template <typename Receiver2>
+    explicit operation(basic_any_sender_of&& sender, Receiver2&& receiver)
+      : receiver_((Receiver2 &&) receiver) {
+      op_ = connect_cpo{}(
+          std::move(sender.sender_),
+          static_cast<receiver_base&>(*this),
+          buffer_.get(),
+          InlineSize);
+    }
+
+    ~operation() {
+      op_->destroy(*this);
+    }
+
+    operation(const operation&) = delete;
+    operation& operator=(const operation&) = delete;
+
+    void start() noexcept {
+      if constexpr (adapt_stop_token) {
+        stopState_.stopCallback_.construct(
+            get_stop_token(receiver_), cancel_operation{*this});
+      }
+      op_->start();
+    }
+
+   private:
+    void value(Values&&... values) noexcept override {
+      stop_complete();
+      cpo::set_value(std::move(receiver_), (Values &&) values...);
+    }
+
+    void error(std::exception_ptr ex) noexcept override {
+      stop_complete();
+      cpo::set_error(std::move(receiver_), std::move(ex));
+    }
+
+    void done() noexcept override {
+      stop_complete();
+      cpo::set_done(std::move(receiver_));
+    }
+
+    void* allocate(std::size_t size) override {
+      allocator_type alloc{get_allocator(std::as_const(receiver_))};
+      return allocator_traits::allocate(alloc, allocation_count(size));
+    }
+
+    void deallocate(void* p, std::size_t size) noexcept override {
+      allocator_type alloc{get_allocator(std::as_const(receiver_))};
+      allocator_traits::deallocate(
+          alloc, static_cast<std::max_align_t*>(p), allocation_count(size));
+    }
+
+    inplace_stop_token stop_token() noexcept override {
+      if constexpr (adapt_stop_token) {
+        return stopState_.stopSource_.get_token();
+      } else if constexpr (std::is_same_v<
+                               stop_token_type,
+                               inplace_stop_token>) {
+        return get_stop_token(receiver_);
+      } else {
+        return inplace_stop_token{};
+      }
+    }
+
+    continuation_info get_continuation_info() const noexcept override {
+      return continuation_info::from_continuation(receiver_);
+    }
+
+    void stop_complete() noexcept {
+      if constexpr (adapt_stop_token) {
+        stopState_.stopCallback_.destruct();
+      }
+    }
+
+    UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+    UNIFEX_NO_UNIQUE_ADDRESS
+    std::conditional_t<adapt_stop_token, stop_state, no_stop_state>
+        stopState_;
+    operation_base* op_;
+    UNIFEX_NO_UNIQUE_ADDRESS detail::any_unique_buffer<InlineSize> buffer_;
+  };
+
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<Values...>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::exception_ptr>;
+
+  template <
+      typename Sender,
+      std::enable_if_t<
+          !std::is_same_v<std::remove_cvref_t<Sender>, basic_any_sender_of>,
+          int> = 0>
+  basic_any_sender_of(Sender&& sender)
+    : sender_((Sender &&) sender) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& receiver) && {
+    return operation<std::remove_cvref_t<Receiver>>{
+        std::move(*this), (Receiver &&) receiver};
+  }
+
+ private:
+  any_unique_sbo<any_sender_of_sender_inline_size, connect_cpo> sender_;
+};
+
+template <typename... Values>
+using any_sender_of =
+    basic_any_sender_of<any_sender_of_default_inline_size, Values...>;
+
+} // namespace unifex
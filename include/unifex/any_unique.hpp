@@ -21,7 +21,10 @@
 #include <unifex/this.hpp>
 #include <unifex/type_traits.hpp>
 
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace unifex {
@@ -202,40 +205,81 @@ inline constexpr struct deallocate_cpo {
   }
 } deallocate;
 
+// Move an object stored inline into 'buffer', destroying the original, and
+// return its new address. Objects that aren't stored inline just return
+// their current address.
+inline constexpr struct move_to_cpo {
+  using type_erased_signature_t = void*(this_&&, void*) noexcept;
+
+  template <
+      typename T,
+      std::enable_if_t<is_tag_invocable_v<move_to_cpo, T&&, void*>, int> = 0>
+  void* operator()(T&& obj, void* buffer) const noexcept {
+    return tag_invoke(move_to_cpo{}, (T &&) obj, buffer);
+  }
+} move_to;
+
+template <std::size_t Size>
+struct any_unique_buffer {
+  void* get() noexcept {
+    return data_;
+  }
+
+  alignas(std::max_align_t) std::byte data_[Size];
+};
+
+template <>
+struct any_unique_buffer<0> {
+  void* get() noexcept {
+    return nullptr;
+  }
+};
+
 } // namespace detail
 
-template <typename... CPOs>
-class any_unique
-    : private detail::
-          with_type_erased_tag_invoke<any_unique<CPOs...>, CPOs>... {
+// A type-erased, move-only owner of an object that supports the CPOs.
+//
+// Objects of up to 'InlineSize' bytes that are nothrow move-constructible
+// are stored inline rather than allocated. Moving the any_unique_sbo then
+// moves the object.
+template <std::size_t InlineSize, typename... CPOs>
+class any_unique_sbo
+    : private detail::with_type_erased_tag_invoke<
+          any_unique_sbo<InlineSize, CPOs...>,
+          CPOs>... {
  public:
   template <typename Concrete, typename Allocator, typename... Args>
-  explicit any_unique(
+  explicit any_unique_sbo(
       std::allocator_arg_t,
       Allocator alloc,
       std::in_place_type_t<Concrete>,
       Args&&... args)
-      : vtable_(vtable_holder_t::template create<
-                concrete_impl<Concrete, Allocator>>()) {
-    using concrete_type = concrete_impl<Concrete, Allocator>;
-    using allocator_type = typename concrete_type::allocator_type;
-    using allocator_traits = std::allocator_traits<allocator_type>;
-    allocator_type typedAllocator{std::move(alloc)};
-    auto ptr = allocator_traits::allocate(typedAllocator, 1);
-    try {
-      // TODO: Ideally we'd use allocator_traits::construct() here but
-      // that makes it difficult to provide consistent behaviour across
-      // std::allocator and std::pmr::polymorphic_allocator as the latter
-      // automatically injects the extra allocator_arg/alloc params which
-      // ends up duplicating them. But std::allocator doesn't do the same
-      // injection of the parameters.
-      ::new ((void*)ptr)
-          concrete_type{std::allocator_arg, typedAllocator, (Args &&) args...};
-    } catch (...) {
-      allocator_traits::deallocate(typedAllocator, ptr, 1);
-      throw;
+      : vtable_(create_vtable<Concrete, Allocator>()) {
+    if constexpr (fits_inline<Concrete>) {
+      (void)alloc;
+      impl_ = ::new (buffer_.get())
+          inline_impl<Concrete>{std::in_place, (Args &&) args...};
+    } else {
+      using concrete_type = concrete_impl<Concrete, Allocator>;
+      using allocator_type = typename concrete_type::allocator_type;
+      using allocator_traits = std::allocator_traits<allocator_type>;
+      allocator_type typedAllocator{std::move(alloc)};
+      auto ptr = allocator_traits::allocate(typedAllocator, 1);
+      try {
+        // TODO: Ideally we'd use allocator_traits::construct() here but
+        // that makes it difficult to provide consistent behaviour across
+        // std::allocator and std::pmr::polymorphic_allocator as the latter
+        // automatically injects the extra allocator_arg/alloc params which
+        // ends up duplicating them. But std::allocator doesn't do the same
+        // injection of the parameters.
+        ::new ((void*)ptr) concrete_type{
+            std::allocator_arg, typedAllocator, (Args &&) args...};
+      } catch (...) {
+        allocator_traits::deallocate(typedAllocator, ptr, 1);
+        throw;
+      }
+      impl_ = static_cast<void*>(ptr);
     }
-    impl_ = static_cast<void*>(ptr);
   }
 
   template <
@@ -245,16 +289,16 @@ class any_unique
           !(std::is_same_v<std::allocator_arg_t, std::decay_t<Concrete>> ||
             instance_of_v<std::in_place_type_t, std::decay_t<Concrete>>),
           int> = 0>
-  any_unique(Concrete&& concrete, Allocator alloc)
-      : any_unique(
+  any_unique_sbo(Concrete&& concrete, Allocator alloc)
+      : any_unique_sbo(
             std::allocator_arg,
             std::move(alloc),
             std::in_place_type<std::remove_cvref_t<Concrete>>,
             (Concrete &&) concrete) {}
 
   template <typename Concrete, typename... Args>
-  explicit any_unique(std::in_place_type_t<Concrete> tag, Args&&... args)
-      : any_unique(
+  explicit any_unique_sbo(std::in_place_type_t<Concrete> tag, Args&&... args)
+      : any_unique_sbo(
             std::allocator_arg,
             std::allocator<unsigned char>{},
             tag,
@@ -263,15 +307,15 @@ class any_unique
   template <
       typename Concrete,
       std::enable_if_t<!instance_of_v<std::in_place_type_t, Concrete>, int> = 0>
-  any_unique(Concrete&& concrete)
-      : any_unique(
+  any_unique_sbo(Concrete&& concrete)
+      : any_unique_sbo(
             std::in_place_type<std::remove_cvref_t<Concrete>>,
             (Concrete &&) concrete) {}
 
-  any_unique(any_unique&& other) noexcept
-      : impl_(std::exchange(other.impl_, nullptr)), vtable_(other.vtable_) {}
+  any_unique_sbo(any_unique_sbo&& other) noexcept
+      : impl_(other.move_object_to(buffer_.get())), vtable_(other.vtable_) {}
 
-  ~any_unique() {
+  ~any_unique_sbo() {
     if (impl_ != nullptr) {
       auto* deallocateFn = vtable_->template get<detail::deallocate_cpo>();
       deallocateFn(detail::deallocate_cpo{}, impl_);
@@ -279,8 +323,71 @@ class any_unique
   }
 
  private:
-  using vtable_holder_t =
-      detail::vtable_holder<detail::deallocate_cpo, CPOs...>;
+  // Objects that aren't stored inline never need moving so there's only a
+  // move_to entry if some objects may be.
+  using vtable_holder_t = std::conditional_t<
+      (InlineSize > 0),
+      detail::
+          vtable_holder<detail::deallocate_cpo, detail::move_to_cpo, CPOs...>,
+      detail::vtable_holder<detail::deallocate_cpo, CPOs...>>;
+
+  // An object stored inline.
+  template <typename Concrete>
+  struct inline_impl final : private detail::with_forwarding_tag_invoke<
+                                 inline_impl<Concrete>,
+                                 CPOs>... {
+    template <typename... Args>
+    explicit inline_impl(std::in_place_t, Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<Concrete, Args...>)
+        : value((Args &&) args...) {}
+
+    // There's nothing to deallocate so just destroy it.
+    friend void tag_invoke(
+        detail::deallocate_cpo,
+        inline_impl&& impl) noexcept {
+      impl.~inline_impl();
+    }
+
+    friend void* tag_invoke(
+        detail::move_to_cpo,
+        inline_impl&& impl,
+        void* buffer) noexcept {
+      auto* moved =
+          ::new (buffer) inline_impl{std::in_place, std::move(impl.value)};
+      impl.~inline_impl();
+      return moved;
+    }
+
+    UNIFEX_NO_UNIQUE_ADDRESS Concrete value;
+  };
+
+  template <typename Concrete>
+  static constexpr bool fits_inline = InlineSize > 0 &&
+      sizeof(inline_impl<Concrete>) <= InlineSize &&
+      alignof(inline_impl<Concrete>) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<Concrete>;
+
+  template <typename Concrete, typename Allocator>
+  static vtable_holder_t create_vtable() noexcept {
+    if constexpr (fits_inline<Concrete>) {
+      return vtable_holder_t::template create<inline_impl<Concrete>>();
+    } else {
+      return vtable_holder_t::template create<
+          concrete_impl<Concrete, Allocator>>();
+    }
+  }
+
+  void* move_object_to(void* buffer) noexcept {
+    void* impl = std::exchange(impl_, nullptr);
+    if constexpr (InlineSize > 0) {
+      if (impl != nullptr) {
+        auto* moveFn = vtable_->template get<detail::move_to_cpo>();
+        return moveFn(detail::move_to_cpo{}, impl, buffer);
+      }
+    }
+    (void)buffer;
+    return impl;
+  }
 
   template <typename Concrete, typename Allocator>
   struct concrete_impl final : private detail::with_forwarding_tag_invoke<
@@ -310,6 +417,14 @@ class any_unique
           allocCopy, std::addressof(impl), 1);
     }
 
+    // Allocated objects stay where they are.
+    friend void* tag_invoke(
+        detail::move_to_cpo,
+        concrete_impl&& impl,
+        void*) noexcept {
+      return std::addressof(impl);
+    }
+
     UNIFEX_NO_UNIQUE_ADDRESS Concrete value;
     UNIFEX_NO_UNIQUE_ADDRESS allocator_type alloc;
   };
@@ -327,9 +442,17 @@ class any_unique
 
   void* impl_;
   vtable_holder_t vtable_;
+  UNIFEX_NO_UNIQUE_ADDRESS detail::any_unique_buffer<InlineSize> buffer_;
 };
 
+// Objects are always allocated.
+template <typename... CPOs>
+using any_unique = any_unique_sbo<0, CPOs...>;
+
 template <auto&... CPOs>
 using any_unique_t = any_unique<tag_t<CPOs>...>;
 
+template <std::size_t InlineSize, auto&... CPOs>
+using any_unique_sbo_t = any_unique_sbo<InlineSize, tag_t<CPOs>...>;
+
 } // namespace unifex
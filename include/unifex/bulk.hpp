@@ -0,0 +1,533 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/async_trace.hpp>
+#include <unifex/blocking.hpp>
+#include <unifex/config.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/manual_lifetime_union.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/tag_invoke.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace unifex {
+
+namespace detail {
+
+template <template <typename...> class Variant>
+struct bulk_error_types {
+  template <typename... Errors>
+  using apply = deduplicate_t<Variant<Errors..., std::exception_ptr>>;
+};
+
+} // namespace detail
+
+// Invokes 'func(i, values...)' for each 'i' in [0, shape) on the thread
+// that 'pred' completes on, then completes with the values.
+template <typename Predecessor, typename Shape, typename Func>
+class bulk_sender {
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types =
+      typename Predecessor::template value_types<Variant, Tuple>;
+
+  template <template <typename...> class Variant>
+  using error_types = typename Predecessor::template error_types<
+      detail::bulk_error_types<Variant>::template apply>;
+
+  template <typename Predecessor2, typename Func2>
+  explicit bulk_sender(Predecessor2&& pred, Shape shape, Func2&& func)
+    : pred_((Predecessor2 &&) pred), shape_(shape), func_((Func2 &&) func) {}
+
+  friend constexpr auto tag_invoke(
+      tag_t<cpo::blocking>,
+      const bulk_sender& sender) {
+    return cpo::blocking(sender.pred_);
+  }
+
+ private:
+  template <typename Receiver>
+  struct receiver {
+    Shape shape_;
+    UNIFEX_NO_UNIQUE_ADDRESS Func func_;
+    UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+
+    template <typename... Values>
+    void value(Values&&... values) && noexcept {
+      try {
+        for (Shape i = 0; i < shape_; ++i) {
+          std::invoke(func_, i, values...);
+        }
+        cpo::set_value((Receiver &&) receiver_, (Values &&) values...);
+      } catch (...) {
+        cpo::set_error((Receiver &&) receiver_, std::current_exception());
+      }
+    }
+
+    template <typename Error>
+    void error(Error&& error) && noexcept {
+      cpo::set_error((Receiver &&) receiver_, (Error &&) error);
+    }
+
+    void done() && noexcept {
+      cpo::set_done((Receiver &&) receiver_);
+    }
+
+    template <
+        typename CPO,
+        std::enable_if_t<!cpo::is_receiver_cpo_v<CPO>, int> = 0>
+    friend auto tag_invoke(CPO cpo, const receiver& r) noexcept(
+        std::is_nothrow_invocable_v<CPO, const Receiver&>)
+        -> std::invoke_result_t<CPO, const Receiver&> {
+      return std::move(cpo)(std::as_const(r.receiver_));
+    }
+
+    template <typename VisitFunc>
+    friend void tag_invoke(
+        tag_t<visit_continuations>,
+        const receiver& r,
+        VisitFunc&& f) {
+      std::invoke(f, r.receiver_);
+    }
+  };
+
+ public:
+  template <typename Receiver>
+  auto connect(Receiver&& r) && {
+    return cpo::connect(
+        std::move(pred_),
+        receiver<std::remove_cvref_t<Receiver>>{
+            shape_, std::move(func_), (Receiver &&) r});
+  }
+
+ private:
+  UNIFEX_NO_UNIQUE_ADDRESS Predecessor pred_;
+  Shape shape_;
+  UNIFEX_NO_UNIQUE_ADDRESS Func func_;
+};
+
+// Invokes 'func(i, values...)' for each 'i' in [0, shape) once 'pred'
+// completes, splitting the index space into one chunk per unit of the
+// scheduler's available parallelism and scheduling each chunk onto it.
+// Completes with the values once every chunk has finished.
+template <
+    typename Predecessor,
+    typename Scheduler,
+    typename Shape,
+    typename Func>
+class bulk_via_sender {
+  using schedule_sender_t =
+      decltype(cpo::schedule(std::declval<Scheduler&>()));
+
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types =
+      typename Predecessor::template value_types<Variant, Tuple>;
+
+  template <template <typename...> class Variant>
+  using error_types = typename Predecessor::template error_types<
+      detail::bulk_error_types<Variant>::template apply>;
+
+  template <typename Predecessor2, typename Scheduler2, typename Func2>
+  explicit bulk_via_sender(
+      Predecessor2&& pred,
+      Scheduler2&& scheduler,
+      Shape shape,
+      Func2&& func)
+    : pred_((Predecessor2 &&) pred),
+      scheduler_((Scheduler2 &&) scheduler),
+      shape_(shape),
+      func_((Func2 &&) func) {}
+
+ private:
+  template <typename Receiver>
+  class operation {
+    template <typename... Values>
+    using decayed_tuple = std::tuple<std::decay_t<Values>...>;
+
+    struct predecessor_receiver {
+      operation& op_;
+
+      template <typename... Values>
+      void value(Values&&... values) && noexcept {
+        op_.template start_chunks<Values...>((Values &&) values...);
+      }
+
+      template <typename Error>
+      void error(Error&& error) && noexcept {
+        op_.predOp_.destruct();
+        cpo::set_error(std::move(op_.receiver_), (Error &&) error);
+      }
+
+      void done() && noexcept {
+        op_.predOp_.destruct();
+        cpo::set_done(std::move(op_.receiver_));
+      }
+
+      template <
+          typename CPO,
+          std::enable_if_t<!cpo::is_receiver_cpo_v<CPO>, int> = 0>
+      friend auto tag_invoke(CPO cpo, const predecessor_receiver& r) noexcept(
+          std::is_nothrow_invocable_v<CPO, const Receiver&>)
+          -> std::invoke_result_t<CPO, const Receiver&> {
+        return std::move(cpo)(std::as_const(r.op_.receiver_));
+      }
+
+      template <typename VisitFunc>
+      friend void tag_invoke(
+          tag_t<visit_continuations>,
+          const predecessor_receiver& r,
+          VisitFunc&& f) {
+        std::invoke(f, r.op_.receiver_);
+      }
+    };
+
+    struct chunk_receiver {
+      operation& op_;
+      std::size_t index_;
+
+      void value() && noexcept {
+        op_.run_chunk(index_);
+      }
+
+      template <typename Error>
+      void error(Error&& error) && noexcept {
+        if constexpr (std::is_same_v<std::decay_t<Error>, std::exception_ptr>) {
+          op_.chunk_failed((Error &&) error);
+        } else {
+          op_.chunk_failed(std::make_exception_ptr((Error &&) error));
+        }
+      }
+
+      void done() && noexcept {
+        op_.chunk_stopped();
+      }
+
+      template <
+          typename CPO,
+          std::enable_if_t<!cpo::is_receiver_cpo_v<CPO>, int> = 0>
+      friend auto tag_invoke(CPO cpo, const chunk_receiver& r) noexcept(
+          std::is_nothrow_invocable_v<CPO, const Receiver&>)
+          -> std::invoke_result_t<CPO, const Receiver&> {
+        return std::move(cpo)(std::as_const(r.op_.receiver_));
+      }
+
+      template <typename VisitFunc>
+      friend void tag_invoke(
+          tag_t<visit_continuations>,
+          const chunk_receiver& r,
+          VisitFunc&& f) {
+        std::invoke(f, r.op_.receiver_);
+      }
+    };
+
+    using chunk_operation = operation_t<schedule_sender_t, chunk_receiver>;
+
+   public:
+    template <
+        typename Predecessor2,
+        typename Scheduler2,
+        typename Func2,
+        typename Receiver2>
+    explicit operation(
+        Predecessor2&& pred,
+        Scheduler2&& scheduler,
+        Shape shape,
+        Func2&& func,
+        Receiver2&& receiver)
+      : scheduler_((Scheduler2 &&) scheduler),
+        shape_(shape),
+        func_((Func2 &&) func),
+        receiver_((Receiver2 &&) receiver) {
+      predOp_.construct_from([&] {
+        return cpo::connect(
+            (Predecessor2 &&) pred, predecessor_receiver{*this});
+      });
+    }
+
+    ~operation() {
+      if (!started_) {
+        predOp_.destruct();
+      }
+    }
+
+    operation(const operation&) = delete;
+    operation& operator=(const operation&) = delete;
+
+    void start() noexcept {
+      started_ = true;
+      cpo::start(predOp_.get());
+    }
+
+   private:
+    template <typename... Values, typename... Values2>
+    void start_chunks(Values2&&... values) noexcept {
+      auto& valueTuple = values_.template get<decayed_tuple<Values...>>();
+      try {
+        valueTuple.construct((Values2 &&) values...);
+      } catch (...) {
+        predOp_.destruct();
+        cpo::set_error(std::move(receiver_), std::current_exception());
+        return;
+      }
+      predOp_.destruct();
+
+      runChunk_ = [](operation& op, Shape begin, Shape end) {
+        auto& values =
+            op.values_.template get<decayed_tuple<Values...>>().get();
+        std::apply(
+            [&](auto&... vs) {
+              for (Shape i = begin; i != end; ++i) {
+                std::invoke(op.func_, i, vs...);
+              }
+            },
+            values);
+      };
+      complete_ = [](operation& op) noexcept {
+        // The receiver may destroy the operation so move the values out of
+        // it before completing.
+        auto& valueTuple = op.values_.template get<decayed_tuple<Values...>>();
+        bool destroyedValues = false;
+        try {
+          auto values = std::move(valueTuple.get());
+          valueTuple.destruct();
+          destroyedValues = true;
+          std::apply(
+              [&](auto&... vs) {
+                cpo::set_value(std::move(op.receiver_), std::move(vs)...);
+              },
+              values);
+        } catch (...) {
+          if (!destroyedValues) {
+            valueTuple.destruct();
+          }
+          cpo::set_error(std::move(op.receiver_), std::current_exception());
+        }
+      };
+      discardValues_ = [](operation& op) noexcept {
+        op.values_.template get<decayed_tuple<Values...>>().destruct();
+      };
+
+      if (shape_ <= Shape(0)) {
+        complete_(*this);
+        return;
+      }
+
+      const std::size_t chunkCount = std::min<std::size_t>(
+          std::max<std::size_t>(cpo::available_parallelism(scheduler_), 1),
+          static_cast<std::size_t>(shape_));
+      try {
+        chunks_.reset(new manual_lifetime<chunk_operation>[chunkCount]);
+        for (std::size_t i = 0; i < chunkCount; ++i) {
+          try {
+            chunks_[i].construct_from([&] {
+              return cpo::connect(
+                  cpo::schedule(scheduler_), chunk_receiver{*this, i});
+            });
+          } catch (...) {
+            while (i != 0) {
+              chunks_[--i].destruct();
+            }
+            throw;
+          }
+        }
+      } catch (...) {
+        chunks_.reset();
+        values_.template get<decayed_tuple<Values...>>().destruct();
+        cpo::set_error(std::move(receiver_), std::current_exception());
+        return;
+      }
+
+      chunkCount_ = chunkCount;
+      remaining_.store(chunkCount, std::memory_order_relaxed);
+
+      // The operation may complete, and be destroyed, as soon as the last
+      // chunk has started so don't touch any members from then on.
+      manual_lifetime<chunk_operation>* chunks = chunks_.get();
+      for (std::size_t i = 0; i < chunkCount; ++i) {
+        cpo::start(chunks[i].get());
+      }
+    }
+
+    void run_chunk(std::size_t index) noexcept {
+      if (!failed_.load(std::memory_order_relaxed)) {
+        // Spread the remainder over the first chunks.
+        const Shape count = static_cast<Shape>(chunkCount_);
+        const Shape i = static_cast<Shape>(index);
+        const Shape chunkSize = shape_ / count;
+        const Shape remainder = shape_ % count;
+        const Shape begin = i * chunkSize + std::min(i, remainder);
+        const Shape end = begin + chunkSize + (i < remainder ? 1 : 0);
+        try {
+          runChunk_(*this, begin, end);
+        } catch (...) {
+          chunk_failed(std::current_exception());
+          return;
+        }
+      }
+      chunk_finished();
+    }
+
+    void chunk_failed(std::exception_ptr error) noexcept {
+      if (!failed_.exchange(true, std::memory_order_relaxed)) {
+        error_ = std::move(error);
+      }
+      chunk_finished();
+    }
+
+    void chunk_stopped() noexcept {
+      stopped_.store(true, std::memory_order_relaxed);
+      chunk_finished();
+    }
+
+    void chunk_finished() noexcept {
+      if (remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+
+      for (std::size_t i = 0; i < chunkCount_; ++i) {
+        chunks_[i].destruct();
+      }
+      chunks_.reset();
+
+      if (failed_.load(std::memory_order_relaxed)) {
+        discard_values();
+        auto error = std::move(error_);
+        cpo::set_error(std::move(receiver_), std::move(error));
+      } else if (stopped_.load(std::memory_order_relaxed)) {
+        discard_values();
+        cpo::set_done(std::move(receiver_));
+      } else {
+        complete_(*this);
+      }
+    }
+
+    void discard_values() noexcept {
+      discardValues_(*this);
+    }
+
+    UNIFEX_NO_UNIQUE_ADDRESS Scheduler scheduler_;
+    Shape shape_;
+    UNIFEX_NO_UNIQUE_ADDRESS Func func_;
+    UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+    manual_lifetime<operation_t<Predecessor, predecessor_receiver>> predOp_;
+    UNIFEX_NO_UNIQUE_ADDRESS typename Predecessor::
+        template value_types<manual_lifetime_union, decayed_tuple>
+            values_;
+
+    // Type-erased over the value types that 'pred' completed with.
+    void (*runChunk_)(operation&, Shape, Shape) = nullptr;
+    void (*complete_)(operation&) noexcept = nullptr;
+    void (*discardValues_)(operation&) noexcept = nullptr;
+
+    std::unique_ptr<manual_lifetime<chunk_operation>[]> chunks_;
+    std::size_t chunkCount_ = 0;
+    std::atomic<std::size_t> remaining_{0};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> stopped_{false};
+    std::exception_ptr error_;
+    bool started_ = false;
+  };
+
+ public:
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) && {
+    return operation<std::remove_cvref_t<Receiver>>{
+        std::move(pred_),
+        std::move(scheduler_),
+        shape_,
+        std::move(func_),
+        (Receiver &&) r};
+  }
+
+ private:
+  UNIFEX_NO_UNIQUE_ADDRESS Predecessor pred_;
+  UNIFEX_NO_UNIQUE_ADDRESS Scheduler scheduler_;
+  Shape shape_;
+  UNIFEX_NO_UNIQUE_ADDRESS Func func_;
+};
+
+namespace cpo {
+
+inline constexpr struct bulk_cpo {
+  template <typename Sender, typename Shape, typename Func>
+  auto operator()(Sender&& pred, Shape shape, Func&& func) const {
+    static_assert(std::is_integral_v<Shape>);
+    return bulk_sender<
+        std::remove_cvref_t<Sender>,
+        Shape,
+        std::remove_cvref_t<Func>>{(Sender &&) pred, shape, (Func &&) func};
+  }
+
+  // Schedulers can customise this by providing
+  // tag_invoke(tag_t<cpo::bulk>, Sender&&, Scheduler, Shape, Func&&).
+  template <
+      typename Sender,
+      typename Scheduler,
+      typename Shape,
+      typename Func>
+  auto operator()(
+      Sender&& pred,
+      Scheduler&& scheduler,
+      Shape shape,
+      Func&& func) const {
+    static_assert(std::is_integral_v<Shape>);
+    if constexpr (is_tag_invocable_v<
+                      bulk_cpo,
+                      Sender,
+                      Scheduler,
+                      Shape,
+                      Func>) {
+      return tag_invoke(
+          *this,
+          (Sender &&) pred,
+          (Scheduler &&) scheduler,
+          shape,
+          (Func &&) func);
+    } else {
+      return bulk_via_sender<
+          std::remove_cvref_t<Sender>,
+          std::remove_cvref_t<Scheduler>,
+          Shape,
+          std::remove_cvref_t<Func>>{(Sender &&) pred,
+                                     (Scheduler &&) scheduler,
+                                     shape,
+                                     (Func &&) func};
+    }
+  }
+} bulk;
+
+} // namespace cpo
+
+} // namespace unifex
@@ -116,6 +116,17 @@ class atomic_intrusive_queue {
         static_cast<Item*>(oldValue));
   }
 
+  // Mark the producer as active again if no item has been enqueued since it
+  // was marked as inactive.
+  //
+  // Returns true if the producer was still marked as inactive. Otherwise
+  // an enqueue() has already marked it as active.
+  bool try_mark_active() noexcept {
+    void* oldValue = producer_inactive_value();
+    return head_.compare_exchange_strong(
+        oldValue, nullptr, std::memory_order_relaxed);
+  }
+
  private:
   void* producer_inactive_value() const noexcept {
     // Pick some pointer that is not nullptr and that is
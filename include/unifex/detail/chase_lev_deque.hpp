@@ -0,0 +1,188 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace unifex {
+
+// A Chase-Lev work-stealing deque of pointers.
+//
+// A single owner thread pushes and pops items at the bottom of the deque,
+// in LIFO order, while any number of other threads concurrently steal
+// items from the top, in FIFO order.
+//
+// This follows "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013). The buffer grows when it
+// fills up. Buffers that have been replaced may still be read by a thief
+// that started stealing before the replacement so they are kept alive until
+// the deque is destroyed. As each buffer is twice the size of the previous
+// one this at most doubles the memory used.
+template <typename T>
+class chase_lev_deque {
+  class buffer {
+   public:
+    // Takes ownership of 'previous' once constructed.
+    explicit buffer(std::int64_t capacity, buffer* previous)
+      : mask_(capacity - 1),
+        items_(new std::atomic<T*>[static_cast<std::size_t>(capacity)]),
+        previous_(previous) {
+      assert((capacity & mask_) == 0);
+    }
+
+    std::int64_t capacity() const noexcept {
+      return mask_ + 1;
+    }
+
+    T* get(std::int64_t index) const noexcept {
+      return items_[index & mask_].load(std::memory_order_relaxed);
+    }
+
+    void put(std::int64_t index, T* item) noexcept {
+      items_[index & mask_].store(item, std::memory_order_relaxed);
+    }
+
+   private:
+    const std::int64_t mask_;
+    std::unique_ptr<std::atomic<T*>[]> items_;
+
+    // Keeps the replaced buffers alive for any thief still reading them.
+    std::unique_ptr<buffer> previous_;
+  };
+
+ public:
+  explicit chase_lev_deque(std::size_t initialCapacity = 256)
+    : buffer_(new buffer(round_up_capacity(initialCapacity), nullptr)) {}
+
+  ~chase_lev_deque() {
+    delete buffer_.load(std::memory_order_relaxed);
+  }
+
+  chase_lev_deque(const chase_lev_deque&) = delete;
+  chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+  // Owner only. Push an item onto the bottom of the deque.
+  //
+  // Allocates a larger buffer if the deque is full, which may throw.
+  void push(T* item) {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    buffer* b = buffer_.load(std::memory_order_relaxed);
+    if (bottom - top > b->capacity() - 1) {
+      b = grow(b, top, bottom);
+    }
+    b->put(bottom, item);
+    bottom_.store(bottom + 1, std::memory_order_release);
+  }
+
+  // Owner only. Pop the item most recently pushed, if any.
+  //
+  // Returns nullptr if the deque is empty.
+  T* pop() noexcept {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    buffer* b = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      // Empty.
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T* item = b->get(bottom);
+    if (top == bottom) {
+      // Last item. Race any thieves for it.
+      if (!top_.compare_exchange_strong(
+              top,
+              top + 1,
+              std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // Any thread. Steal the least recently pushed item, if any.
+  //
+  // Returns nullptr if the deque is empty or if another thread took the
+  // item first.
+  T* steal() noexcept {
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+
+    // A buffer we read here is never freed while the deque is alive, and
+    // the CAS below fails if the owner has since reused this slot.
+    T* item = buffer_.load(std::memory_order_acquire)->get(top);
+    if (!top_.compare_exchange_strong(
+            top,
+            top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  // Any thread. Only a snapshot unless called by the owner.
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  // Any thread. Only a snapshot unless called by the owner.
+  std::size_t size() const noexcept {
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+  }
+
+ private:
+  static std::int64_t round_up_capacity(std::size_t capacity) noexcept {
+    std::int64_t result = 2;
+    while (static_cast<std::size_t>(result) < capacity) {
+      result *= 2;
+    }
+    return result;
+  }
+
+  buffer* grow(buffer* old, std::int64_t top, std::int64_t bottom) {
+    buffer* b = new buffer(old->capacity() * 2, old);
+    for (std::int64_t i = top; i != bottom; ++i) {
+      b->put(i, old->get(i));
+    }
+    buffer_.store(b, std::memory_order_release);
+    return b;
+  }
+
+  // Kept on separate cache-lines as thieves write top_ while the owner
+  // writes bottom_.
+  alignas(64) std::atomic<std::int64_t> top_{0};
+  alignas(64) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<buffer*> buffer_;
+};
+
+} // namespace unifex
@@ -16,98 +16,144 @@
 #pragma once
 
 #include <cassert>
+#include <utility>
 
 namespace unifex {
 
-// A doubly-linked intrusive list maintained in ascending order of the 'SortKey'
-// field of the list items.
-template <typename T, T* T::*Next, T* T::*Prev, typename Key, Key T::*SortKey>
+// An intrusive pairing heap ordered by ascending value of the 'SortKey'
+// field of the items.
+//
+// Each item is linked into the heap through three pointers:
+// - 'Child' points to the item's first child.
+// - 'Next' points to the item's next sibling.
+// - 'Prev' points to the item's previous sibling or, for a first child,
+//   to its parent. It is nullptr for the top item.
+//
+// top() is O(1), insert() is O(1) and pop() and remove() are amortised
+// O(log n). Items with equal keys are not removed in any particular order.
+template <
+    typename T,
+    T* T::*Child,
+    T* T::*Next,
+    T* T::*Prev,
+    typename Key,
+    Key T::*SortKey>
 class intrusive_heap {
  public:
-  intrusive_heap() noexcept : head_(nullptr) {}
+  intrusive_heap() noexcept : root_(nullptr) {}
 
   ~intrusive_heap() {
-    T* item = head_;
-    if (item != nullptr) {
-      assert(item->*Prev == nullptr);
-    }
-    while (item != nullptr) {
-      std::printf("- %p\n", item);
-      if (item->*Next != nullptr) {
-        assert(item->*Next->*Prev == item);
-      }
-      item = item->*Next;
-    }
-
     assert(empty());
   }
 
   bool empty() const noexcept {
-    return head_ == nullptr;
+    return root_ == nullptr;
   }
 
   T* top() const noexcept {
     assert(!empty());
-    return head_;
+    return root_;
   }
 
   T* pop() noexcept {
     assert(!empty());
-    T* item = head_;
-    head_ = item->*Next;
-    if (head_ != nullptr) {
-      head_->*Prev = nullptr;
-    }
+    T* item = root_;
+    root_ = merge_pairs(item->*Child);
     return item;
   }
 
   void insert(T* item) noexcept {
-    // Simple insertion sort to insert item in the right place in the list
-    // to keep the list sorted by 'item->*SortKey'.
-    // TODO: Replace this with a non-toy data-structure.
-    if (head_ == nullptr) {
-      head_ = item;
-      item->*Next = nullptr;
-      item->*Prev = nullptr;
-    } else if (item->*SortKey < head_->*SortKey) {
-      item->*Next = head_;
-      item->*Prev = nullptr;
-      head_->*Prev = item;
-      head_ = item;
-    } else {
-      auto* insertAfter = head_;
-      while (insertAfter->*Next != nullptr &&
-             insertAfter->*Next->*SortKey <= item->*SortKey) {
-        insertAfter = insertAfter->*Next;
-      }
-
-      auto* insertBefore = insertAfter->*Next;
-
-      item->*Prev = insertAfter;
-      item->*Next = insertBefore;
-      insertAfter->*Next = item;
-      if (insertBefore != nullptr) {
-        insertBefore->*Prev = item;
-      }
-    }
+    item->*Child = nullptr;
+    item->*Next = nullptr;
+    item->*Prev = nullptr;
+    root_ = root_ != nullptr ? link_roots(root_, item) : item;
   }
 
   void remove(T* item) noexcept {
-    auto* prev = item->*Prev;
-    auto* next = item->*Next;
-    if (prev != nullptr) {
-      prev->*Next = next;
+    if (item == root_) {
+      (void)pop();
+      return;
+    }
+
+    // Unlink the item (and its children) from its parent and siblings.
+    T* prev = item->*Prev;
+    T* next = item->*Next;
+    assert(prev != nullptr);
+    if (prev->*Child == item) {
+      prev->*Child = next;
     } else {
-      assert(head_ == item);
-      head_ = next;
+      prev->*Next = next;
     }
     if (next != nullptr) {
       next->*Prev = prev;
     }
+
+    // Then merge its children back into the heap.
+    if (T* children = merge_pairs(item->*Child); children != nullptr) {
+      root_ = link_roots(root_, children);
+    }
   }
 
  private:
-  T* head_;
+  // Link two trees, making the one with the larger key the first child
+  // of the other. Returns the new root, with its 'Next' and 'Prev' cleared.
+  static T* link_roots(T* a, T* b) noexcept {
+    if (b->*SortKey < a->*SortKey) {
+      std::swap(a, b);
+    }
+
+    T* firstChild = a->*Child;
+    b->*Next = firstChild;
+    b->*Prev = a;
+    if (firstChild != nullptr) {
+      firstChild->*Prev = b;
+    }
+    a->*Child = b;
+    a->*Next = nullptr;
+    a->*Prev = nullptr;
+    return a;
+  }
+
+  // Merge a list of sibling trees into a single tree using the standard
+  // two-pass pairing: link adjacent pairs left-to-right, then fold the
+  // results right-to-left.
+  static T* merge_pairs(T* first) noexcept {
+    if (first == nullptr) {
+      return nullptr;
+    }
+
+    // First pass. The linked pairs are pushed onto a list threaded through
+    // 'Next' so that it ends up in reverse order.
+    T* pairs = nullptr;
+    while (first != nullptr) {
+      T* a = first;
+      T* b = a->*Next;
+      if (b == nullptr) {
+        a->*Next = pairs;
+        pairs = a;
+        break;
+      }
+      first = b->*Next;
+      T* linked = link_roots(a, b);
+      linked->*Next = pairs;
+      pairs = linked;
+    }
+
+    // Second pass.
+    T* result = pairs;
+    pairs = pairs->*Next;
+    while (pairs != nullptr) {
+      T* next = pairs->*Next;
+      result = link_roots(result, pairs);
+      pairs = next;
+    }
+
+    result->*Next = nullptr;
+    result->*Prev = nullptr;
+    return result;
+  }
+
+  T* root_;
 };
 
 } // namespace unifex
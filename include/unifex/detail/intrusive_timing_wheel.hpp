@@ -0,0 +1,274 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/detail/intrusive_queue.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+
+namespace unifex {
+
+// A hierarchical hashed timing wheel holding items that become due at the
+// time stored in their 'DueTime' field.
+//
+// Time is divided into ticks of a fixed duration, counted from an origin.
+// An item's due time is rounded up to a whole tick so items are never
+// returned before they are due, but may be returned up to one tick late.
+//
+// The wheel has four levels of 64 slots. Level 0 holds items due within
+// the next 64 ticks, one tick per slot. Each higher level holds items due
+// further in the future with 64 times coarser slots. When time reaches the
+// start of a higher-level slot its items are moved down to the lower levels.
+// Items due beyond the range of the top level are parked in its furthest
+// slot and re-placed each time that slot comes round.
+//
+// Items are linked into a slot through 'Next', and 'Prev' points at the
+// pointer that points at the item, which makes insert() and remove() O(1).
+// 'Prev' is nullptr for items that are not in the wheel.
+template <
+    typename T,
+    T* T::*Next,
+    T** T::*Prev,
+    typename TimePoint,
+    TimePoint T::*DueTime>
+class intrusive_timing_wheel {
+  static constexpr std::uint32_t level_bits = 6;
+  static constexpr std::uint32_t level_count = 4;
+  static constexpr std::size_t slots_per_level = std::size_t(1) << level_bits;
+  static constexpr std::size_t slot_mask = slots_per_level - 1;
+
+  // Slot holding items that were already due when they were inserted.
+  static constexpr std::size_t overdue_slot = level_count * slots_per_level;
+
+ public:
+  using duration = typename TimePoint::duration;
+
+  intrusive_timing_wheel(TimePoint origin, duration tick) noexcept
+      : origin_(origin), tick_(tick) {
+    assert(tick_.count() > 0);
+  }
+
+  ~intrusive_timing_wheel() {
+    assert(empty());
+  }
+
+  intrusive_timing_wheel(const intrusive_timing_wheel&) = delete;
+  intrusive_timing_wheel& operator=(const intrusive_timing_wheel&) = delete;
+
+  bool empty() const noexcept {
+    return count_ == 0;
+  }
+
+  duration tick() const noexcept {
+    return tick_;
+  }
+
+  void insert(T* item) noexcept {
+    ++count_;
+    place(item);
+  }
+
+  void remove(T* item) noexcept {
+    assert(item->*Prev != nullptr);
+    T** prev = item->*Prev;
+    T* next = item->*Next;
+    *prev = next;
+    if (next != nullptr) {
+      next->*Prev = prev;
+    } else if (
+        !std::less<T**>{}(prev, slots_) &&
+        std::less<T**>{}(prev, slots_ + overdue_slot)) {
+      // The item may have been the only one in its slot.
+      const std::size_t slot = static_cast<std::size_t>(prev - slots_);
+      if (slots_[slot] == nullptr) {
+        occupied_[slot / slots_per_level] &=
+            ~(std::uint64_t(1) << (slot & slot_mask));
+      }
+    }
+    item->*Prev = nullptr;
+    --count_;
+  }
+
+  // Remove all of the items that are due at or before 'now', in no
+  // particular order.
+  intrusive_queue<T, Next> pop_expired(const TimePoint& now) noexcept {
+    intrusive_queue<T, Next> expired;
+    expire_slot(overdue_slot, expired);
+
+    if (now < origin_) {
+      return expired;
+    }
+
+    const std::uint64_t lastTick = static_cast<std::uint64_t>(
+        (now - origin_).count() / tick_.count());
+    while (currentTick_ <= lastTick) {
+      if (count_ == 0) {
+        currentTick_ = lastTick + 1;
+        break;
+      }
+
+      // Move items down from any higher-level slots that start at this
+      // tick, coarsest first, then expire the level 0 slot for the tick.
+      for (std::uint32_t level = level_count - 1; level > 0; --level) {
+        const std::uint32_t shift = level * level_bits;
+        if ((currentTick_ & ((std::uint64_t(1) << shift) - 1)) == 0) {
+          cascade(level, (currentTick_ >> shift) & slot_mask);
+        }
+      }
+      expire_slot(currentTick_ & slot_mask, expired);
+
+      ++currentTick_;
+      if (count_ != 0) {
+        // Skip over the ticks with nothing to do.
+        currentTick_ = std::min(next_event_tick(), lastTick + 1);
+      }
+    }
+
+    return expired;
+  }
+
+  // The time at which pop_expired() should next be called. This is no later
+  // than the earliest due time, rounded up to a tick, but may be earlier if
+  // items need to move between levels first.
+  //
+  // Returns std::nullopt if the wheel is empty.
+  std::optional<TimePoint> next_expiry_time() const noexcept {
+    if (count_ == 0) {
+      return std::nullopt;
+    }
+    if (slots_[overdue_slot] != nullptr) {
+      return origin_;
+    }
+    return origin_ +
+        duration(tick_.count() *
+                 static_cast<typename duration::rep>(next_event_tick()));
+  }
+
+ private:
+  // The first tick at or after 'dueTime'.
+  std::uint64_t tick_of(const TimePoint& dueTime) const noexcept {
+    if (dueTime <= origin_) {
+      return 0;
+    }
+    const auto offset = (dueTime - origin_).count();
+    const auto tickCount = tick_.count();
+    return static_cast<std::uint64_t>(
+        offset / tickCount + (offset % tickCount != 0 ? 1 : 0));
+  }
+
+  void place(T* item) noexcept {
+    std::uint64_t tick = tick_of(item->*DueTime);
+    if (tick < currentTick_) {
+      push_slot(overdue_slot, item);
+      return;
+    }
+
+    constexpr std::uint64_t maxDelta =
+        (std::uint64_t(1) << (level_bits * level_count)) - 1;
+    const std::uint64_t delta = std::min(tick - currentTick_, maxDelta);
+    tick = currentTick_ + delta;
+
+    std::uint32_t level = 0;
+    while (delta >> ((level + 1) * level_bits) != 0) {
+      ++level;
+    }
+
+    const std::size_t slot = (tick >> (level * level_bits)) & slot_mask;
+    occupied_[level] |= std::uint64_t(1) << slot;
+    push_slot(level * slots_per_level + slot, item);
+  }
+
+  void push_slot(std::size_t slot, T* item) noexcept {
+    T*& head = slots_[slot];
+    item->*Next = head;
+    item->*Prev = &head;
+    if (head != nullptr) {
+      head->*Prev = &(item->*Next);
+    }
+    head = item;
+  }
+
+  T* take_slot(std::size_t slot) noexcept {
+    if (slot != overdue_slot) {
+      occupied_[slot / slots_per_level] &=
+          ~(std::uint64_t(1) << (slot & slot_mask));
+    }
+    T* head = slots_[slot];
+    slots_[slot] = nullptr;
+    return head;
+  }
+
+  void cascade(std::uint32_t level, std::size_t slot) noexcept {
+    T* item = take_slot(level * slots_per_level + slot);
+    while (item != nullptr) {
+      T* next = item->*Next;
+      place(item);
+      item = next;
+    }
+  }
+
+  void expire_slot(
+      std::size_t slot,
+      intrusive_queue<T, Next>& expired) noexcept {
+    T* item = take_slot(slot);
+    while (item != nullptr) {
+      T* next = item->*Next;
+      item->*Prev = nullptr;
+      expired.push_back(item);
+      --count_;
+      item = next;
+    }
+  }
+
+  // The first tick at or after currentTick_ at which a level 0 slot expires
+  // or a higher-level slot needs moving down.
+  std::uint64_t next_event_tick() const noexcept {
+    std::uint64_t result = std::numeric_limits<std::uint64_t>::max();
+    for (std::uint32_t level = 0; level < level_count; ++level) {
+      const std::uint64_t bits = occupied_[level];
+      if (bits == 0) {
+        continue;
+      }
+
+      // The first slot-sized block that starts at or after currentTick_.
+      const std::uint32_t shift = level * level_bits;
+      const std::uint64_t block =
+          (currentTick_ + (std::uint64_t(1) << shift) - 1) >> shift;
+      const std::uint32_t rotate = block & slot_mask;
+      const std::uint64_t rotated = rotate == 0
+          ? bits
+          : (bits >> rotate) | (bits << (slots_per_level - rotate));
+      const std::uint64_t offset = __builtin_ctzll(rotated);
+      result = std::min(result, (block + offset) << shift);
+    }
+    return result;
+  }
+
+  TimePoint origin_;
+  duration tick_;
+  std::uint64_t currentTick_ = 0;
+  std::size_t count_ = 0;
+  std::uint64_t occupied_[level_count] = {};
+  T* slots_[overdue_slot + 1] = {};
+};
+
+} // namespace unifex
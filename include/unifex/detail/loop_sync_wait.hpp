@@ -0,0 +1,156 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/get_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace unifex {
+
+namespace detail {
+
+// The result of a sync_wait() that runs an event loop on the calling thread
+// until the sender completes.
+//
+// Once the result has been stored the receiver calls the loop's 'wake up'
+// function to make the loop return. If the sender completed on another
+// thread the loop may see the result before that function has returned, so
+// get() waits for it to return before the loop can be destroyed.
+template <typename T>
+class loop_sync_wait_promise {
+ public:
+  enum class state { incomplete, done, value, error };
+
+  loop_sync_wait_promise() noexcept {}
+
+  ~loop_sync_wait_promise() {
+    if (state_ == state::value) {
+      value_.destruct();
+    } else if (state_ == state::error) {
+      exception_.destruct();
+    }
+  }
+
+  loop_sync_wait_promise(const loop_sync_wait_promise&) = delete;
+  loop_sync_wait_promise& operator=(const loop_sync_wait_promise&) = delete;
+
+  const std::atomic<bool>& completed() const noexcept {
+    return completed_;
+  }
+
+  template <typename... Values>
+  void set_value(Values&&... values) noexcept {
+    try {
+      value_.construct((Values &&) values...);
+      state_ = state::value;
+    } catch (...) {
+      exception_.construct(std::current_exception());
+      state_ = state::error;
+    }
+  }
+
+  void set_error(std::exception_ptr ex) noexcept {
+    exception_.construct(std::move(ex));
+    state_ = state::error;
+  }
+
+  void set_done() noexcept {
+    state_ = state::done;
+  }
+
+  // Call after one of the set_*() functions.
+  template <typename WakeUp>
+  void complete(WakeUp& wakeUp) noexcept {
+    wakingUp_.store(true, std::memory_order_relaxed);
+    completed_.store(true, std::memory_order_release);
+    wakeUp();
+    wakingUp_.store(false, std::memory_order_release);
+  }
+
+  // Call once the loop has returned.
+  std::optional<T> get() && {
+    assert(completed_.load(std::memory_order_relaxed));
+    while (wakingUp_.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+
+    switch (state_) {
+      case state::done:
+        return std::nullopt;
+      case state::value:
+        return std::move(value_).get();
+      case state::error:
+        std::rethrow_exception(exception_.get());
+      default:
+        std::terminate();
+    }
+  }
+
+ private:
+  union {
+    manual_lifetime<T> value_;
+    manual_lifetime<std::exception_ptr> exception_;
+  };
+
+  state state_ = state::incomplete;
+  std::atomic<bool> completed_{false};
+  std::atomic<bool> wakingUp_{false};
+};
+
+template <typename T, typename StopToken, typename WakeUp>
+struct loop_sync_wait_receiver {
+  loop_sync_wait_promise<T>& promise_;
+  StopToken stopToken_;
+  WakeUp wakeUp_;
+
+  template <typename... Values>
+  void value(Values&&... values) && noexcept {
+    promise_.set_value((Values &&) values...);
+    promise_.complete(wakeUp_);
+  }
+
+  void error(std::exception_ptr ex) && noexcept {
+    promise_.set_error(std::move(ex));
+    promise_.complete(wakeUp_);
+  }
+
+  template <typename Error>
+  void error(Error&& e) && noexcept {
+    std::move(*this).error(std::make_exception_ptr((Error &&) e));
+  }
+
+  void done() && noexcept {
+    promise_.set_done();
+    promise_.complete(wakeUp_);
+  }
+
+  friend const StopToken& tag_invoke(
+      tag_t<get_stop_token>,
+      const loop_sync_wait_receiver& r) noexcept {
+    return r.stopToken_;
+  }
+};
+
+} // namespace detail
+
+} // namespace unifex
@@ -63,6 +63,58 @@ inline constexpr struct async_write_some_at_cpo {
   }
 } async_write_some_at;
 
+// As async_read_some_at() but fails with std::errc::timed_out if the read
+// has not completed by the specified deadline.
+inline constexpr struct async_read_some_at_until_cpo {
+  template <typename AsyncFile, typename BufferSequence, typename TimePoint>
+  auto operator()(
+      AsyncFile& file,
+      typename AsyncFile::offset_t offset,
+      BufferSequence&& bufferSequence,
+      const TimePoint& deadline) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_read_some_at_until_cpo,
+               AsyncFile&,
+               typename AsyncFile::offset_t,
+               BufferSequence,
+               const TimePoint&>)
+          -> tag_invoke_result_t<
+              async_read_some_at_until_cpo,
+              AsyncFile&,
+              typename AsyncFile::offset_t,
+              BufferSequence,
+              const TimePoint&> {
+    return unifex::tag_invoke(
+        *this, file, offset, (BufferSequence &&) bufferSequence, deadline);
+  }
+} async_read_some_at_until;
+
+// As async_write_some_at() but fails with std::errc::timed_out if the write
+// has not completed by the specified deadline.
+inline constexpr struct async_write_some_at_until_cpo {
+  template <typename AsyncFile, typename BufferSequence, typename TimePoint>
+  auto operator()(
+      AsyncFile& file,
+      typename AsyncFile::offset_t offset,
+      BufferSequence&& bufferSequence,
+      const TimePoint& deadline) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_write_some_at_until_cpo,
+               AsyncFile&,
+               typename AsyncFile::offset_t,
+               BufferSequence,
+               const TimePoint&>)
+          -> tag_invoke_result_t<
+              async_write_some_at_until_cpo,
+              AsyncFile&,
+              typename AsyncFile::offset_t,
+              BufferSequence,
+              const TimePoint&> {
+    return unifex::tag_invoke(
+        *this, file, offset, (BufferSequence &&) bufferSequence, deadline);
+  }
+} async_write_some_at_until;
+
 inline constexpr struct open_file_read_only_cpo {
   template <typename Executor>
   auto operator()(Executor&& executor, const filesystem::path& path) const
@@ -108,4 +160,108 @@ inline constexpr struct open_file_read_write_cpo {
   }
 } open_file_read_write;
 
+inline constexpr struct async_open_file_read_only_cpo {
+  template <typename Executor>
+  auto operator()(Executor&& executor, const filesystem::path& path) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_open_file_read_only_cpo,
+               Executor,
+               const filesystem::path&>)
+          -> tag_invoke_result_t<
+              async_open_file_read_only_cpo,
+              Executor,
+              const filesystem::path&> {
+    return unifex::tag_invoke(*this, (Executor &&) executor, path);
+  }
+} async_open_file_read_only;
+
+inline constexpr struct async_open_file_write_only_cpo {
+  template <typename Executor>
+  auto operator()(Executor&& executor, const filesystem::path& path) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_open_file_write_only_cpo,
+               Executor,
+               const filesystem::path&>)
+          -> tag_invoke_result_t<
+              async_open_file_write_only_cpo,
+              Executor,
+              const filesystem::path&> {
+    return unifex::tag_invoke(*this, (Executor &&) executor, path);
+  }
+} async_open_file_write_only;
+
+inline constexpr struct async_open_file_read_write_cpo {
+  template <typename Executor>
+  auto operator()(Executor&& executor, const filesystem::path& path) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_open_file_read_write_cpo,
+               Executor,
+               const filesystem::path&>)
+          -> tag_invoke_result_t<
+              async_open_file_read_write_cpo,
+              Executor,
+              const filesystem::path&> {
+    return unifex::tag_invoke(*this, (Executor &&) executor, path);
+  }
+} async_open_file_read_write;
+
+inline constexpr struct async_close_cpo {
+  template <typename AsyncFile>
+  auto operator()(AsyncFile& file) const
+      noexcept(is_nothrow_tag_invocable_v<async_close_cpo, AsyncFile&>)
+          -> tag_invoke_result_t<async_close_cpo, AsyncFile&> {
+    return unifex::tag_invoke(*this, file);
+  }
+} async_close;
+
+inline constexpr struct async_statx_cpo {
+  template <typename AsyncFile>
+  auto operator()(AsyncFile& file) const
+      noexcept(is_nothrow_tag_invocable_v<async_statx_cpo, AsyncFile&>)
+          -> tag_invoke_result_t<async_statx_cpo, AsyncFile&> {
+    return unifex::tag_invoke(*this, file);
+  }
+} async_statx;
+
+inline constexpr struct async_fsync_cpo {
+  template <typename AsyncFile>
+  auto operator()(AsyncFile& file) const
+      noexcept(is_nothrow_tag_invocable_v<async_fsync_cpo, AsyncFile&>)
+          -> tag_invoke_result_t<async_fsync_cpo, AsyncFile&> {
+    return unifex::tag_invoke(*this, file);
+  }
+} async_fsync;
+
+inline constexpr struct async_fdatasync_cpo {
+  template <typename AsyncFile>
+  auto operator()(AsyncFile& file) const
+      noexcept(is_nothrow_tag_invocable_v<async_fdatasync_cpo, AsyncFile&>)
+          -> tag_invoke_result_t<async_fdatasync_cpo, AsyncFile&> {
+    return unifex::tag_invoke(*this, file);
+  }
+} async_fdatasync;
+
+inline constexpr struct async_fallocate_cpo {
+  template <typename AsyncFile>
+  auto operator()(
+      AsyncFile& file,
+      int mode,
+      typename AsyncFile::offset_t offset,
+      typename AsyncFile::offset_t length) const
+      noexcept(is_nothrow_tag_invocable_v<
+               async_fallocate_cpo,
+               AsyncFile&,
+               int,
+               typename AsyncFile::offset_t,
+               typename AsyncFile::offset_t>)
+          -> tag_invoke_result_t<
+              async_fallocate_cpo,
+              AsyncFile&,
+              int,
+              typename AsyncFile::offset_t,
+              typename AsyncFile::offset_t> {
+    return unifex::tag_invoke(*this, file, mode, offset, length);
+  }
+} async_fallocate;
+
 } // namespace unifex
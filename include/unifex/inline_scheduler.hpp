@@ -16,6 +16,7 @@
 #pragma once
 
 #include <unifex/blocking.hpp>
+#include <unifex/bulk.hpp>
 #include <unifex/config.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/receiver_concepts.hpp>
@@ -75,6 +76,17 @@ struct inline_scheduler {
   schedule_task schedule() {
     return {};
   }
+
+  // There is no parallelism to be had so run the whole index space inline.
+  template <typename Sender, typename Shape, typename Func>
+  friend auto tag_invoke(
+      tag_t<cpo::bulk>,
+      Sender&& pred,
+      const inline_scheduler&,
+      Shape shape,
+      Func&& func) {
+    return cpo::bulk((Sender &&) pred, shape, (Func &&) func);
+  }
 };
 
 } // namespace unifex
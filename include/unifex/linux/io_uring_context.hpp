@@ -15,35 +15,65 @@
  */
 #pragma once
 
+#include <unifex/config.hpp>
 #include <unifex/detail/atomic_intrusive_queue.hpp>
 #include <unifex/detail/intrusive_heap.hpp>
 #include <unifex/detail/intrusive_queue.hpp>
+#include <unifex/detail/intrusive_timing_wheel.hpp>
+#include <unifex/detail/loop_sync_wait.hpp>
 #include <unifex/file_concepts.hpp>
 #include <unifex/filesystem.hpp>
+#include <unifex/get_allocator.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
 #include <unifex/span.hpp>
 #include <unifex/stop_token_concepts.hpp>
+#include <unifex/timer_backend.hpp>
+#include <unifex/unstoppable_token.hpp>
 
 #include <unifex/linux/mmap_region.hpp>
 #include <unifex/linux/monotonic_clock.hpp>
 #include <unifex/linux/safe_file_descriptor.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <system_error>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <liburing.h>
 
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/uio.h>
 
 namespace unifex {
 namespace linux {
 
+// True if BufferSequence is a range whose elements are convertible to
+// span<Byte>, e.g. a std::vector<span<std::byte>>.
+template <typename BufferSequence, typename Byte, typename = void>
+inline constexpr bool is_buffer_sequence_v = false;
+
+template <typename BufferSequence, typename Byte>
+inline constexpr bool is_buffer_sequence_v<
+    BufferSequence,
+    Byte,
+    std::void_t<decltype(*std::begin(std::declval<const BufferSequence&>()))>> =
+    std::is_convertible_v<
+        decltype(*std::begin(std::declval<const BufferSequence&>())),
+        span<Byte>>;
+
 class io_uring_context {
  public:
   class schedule_sender;
@@ -52,20 +82,146 @@ class io_uring_context {
   class schedule_after_sender;
   class read_sender;
   class write_sender;
+  template <typename BufferSequence>
+  class readv_sender;
+  template <typename BufferSequence>
+  class writev_sender;
+  template <typename File>
+  class open_sender;
+  class close_sender;
+  class statx_sender;
+  class fsync_sender;
+  class fallocate_sender;
+  class async_file_base;
   class async_read_only_file;
   class async_read_write_file;
   class async_write_only_file;
   class scheduler;
+  class registered_buffer_pool;
+
+  using time_point = linux::monotonic_clock::time_point;
+
+  // Parameters controlling the creation of the underlying io_uring.
+  struct options {
+    // Number of entries in the submission queue.
+    // The kernel rounds this up to the next power of two.
+    std::uint32_t submissionQueueEntries = 256;
+
+    // Number of entries in the completion queue.
+    // If zero then the kernel default (twice the submission queue size)
+    // is used, otherwise this is passed as IORING_SETUP_CQSIZE.
+    // Must not be less than submissionQueueEntries.
+    std::uint32_t completionQueueEntries = 0;
+
+    // If true then sizes that exceed the kernel's limits are clamped to
+    // the maximum supported size (IORING_SETUP_CLAMP) rather than failing.
+    bool clampEntries = false;
+
+    // Additional IORING_SETUP_* flags to pass to io_uring_setup().
+    std::uint32_t setupFlags = 0;
+
+    // If true then the kernel creates a thread that polls the submission
+    // queue for new entries (IORING_SETUP_SQPOLL) so that the I/O thread
+    // does not need to make a system call to submit I/O. The I/O thread only
+    // calls io_uring_enter() to wake the polling thread once it has gone
+    // idle or to block waiting for completions.
+    bool submissionQueuePolling = false;
+
+    // Number of milliseconds the kernel polling thread spins without any
+    // new submissions before going to sleep. Zero selects the kernel default.
+    // Only used if submissionQueuePolling is true.
+    std::uint32_t submissionQueueThreadIdleMs = 0;
+
+    // If set then the kernel polling thread is bound to this CPU
+    // (IORING_SETUP_SQ_AFF). Only used if submissionQueuePolling is true.
+    std::optional<std::uint32_t> submissionQueueThreadCpu;
+
+    // Number of slots in the context's table of registered buffers.
+    // Buffers can only be registered with register_buffer() if this is
+    // non-zero. Requires a kernel that supports sparse buffer registration.
+    std::uint32_t registeredBufferSlots = 0;
+
+    // Number of slots in the context's table of registered files.
+    // Files can only be registered with register_file() if this is non-zero.
+    // Requires a kernel that supports sparse file registration.
+    std::uint32_t registeredFileSlots = 0;
+
+    // How pending schedule_at() timers are stored. With
+    // timer_backend::timing_wheel, timers elapse on the first multiple of
+    // 'timerWheelTick' since the context was created that is at or after
+    // their due time.
+    timer_backend timerBackend = timer_backend::priority_queue;
+    std::chrono::nanoseconds timerWheelTick = default_timing_wheel_tick;
+
+    // Contexts created with the same non-null wakeup group wake each
+    // other's I/O threads by posting a message between their rings with
+    // IORING_OP_MSG_RING rather than through the target's eventfd.
+    // The sending context handles the completion of the message, and
+    // falls back to the eventfd if it failed, so every context in a group
+    // must outlive the run() loops of all the others. io_uring_pool puts
+    // all of its rings in one group.
+    const void* wakeupGroup = nullptr;
+  };
 
   io_uring_context();
 
+  explicit io_uring_context(const options& opts);
+
   ~io_uring_context();
 
   template <typename StopToken>
   void run(StopToken stopToken);
 
+  // Runs the I/O loop on the calling thread until 'sender' has completed and
+  // returns its result, as for unifex::sync_wait(). The sender is started
+  // from inside the loop.
+  //
+  // Must not be called while run() is running on another thread.
+  template <
+      typename Sender,
+      typename StopToken = unstoppable_token,
+      typename Result = single_value_result_t<std::remove_cvref_t<Sender>>>
+  std::optional<Result> sync_wait(Sender&& sender, StopToken&& st = {});
+
   scheduler get_scheduler() noexcept;
 
+  // Register a region of memory with the kernel, in a free slot of the
+  // sparse buffer table registered with IORING_REGISTER_BUFFERS2 (filled in
+  // with IORING_REGISTER_BUFFERS_UPDATE), so that reads and writes whose
+  // buffer lies entirely within the region use IORING_OP_READ_FIXED/
+  // IORING_OP_WRITE_FIXED and avoid the kernel mapping the user pages on
+  // every operation.
+  //
+  // Returns the index of the slot the buffer was registered in.
+  // Throws std::system_error if there are no free slots or registration
+  // fails. May be called from any thread.
+  std::uint32_t register_buffer(span<std::byte> buffer);
+
+  // Remove a buffer previously registered with register_buffer().
+  // There must not be any I/O operations in flight that use the buffer.
+  void unregister_buffer(std::uint32_t index) noexcept;
+
+  // Register a file descriptor in a free slot of the context's table of
+  // registered files (IORING_REGISTER_FILES). I/O submitted against the
+  // slot index with IOSQE_FIXED_FILE avoids the kernel looking up the file
+  // on every operation. The registration holds its own reference to the
+  // file.
+  //
+  // Returns the index of the slot. Throws std::system_error if there are
+  // no free slots or registration fails. May be called from any thread.
+  std::uint32_t register_file(int fd);
+
+  // Remove a file previously registered with register_file().
+  // There must not be any I/O operations in flight that use the slot.
+  void unregister_file(std::uint32_t index) noexcept;
+
+  // An estimate of the number of operations submitted to the kernel that
+  // have not yet completed. Published by the I/O thread each time around
+  // its run loop. May be called from any thread.
+  std::uint32_t pending_io_count_estimate() const noexcept {
+    return pendingIoCountEstimate_.load(std::memory_order_relaxed);
+  }
+
  private:
   struct operation_base {
     operation_base() noexcept {}
@@ -77,6 +233,12 @@ class io_uring_context {
     int result_;
   };
 
+  template <typename Derived, typename Receiver, bool Cancellable>
+  class io_operation;
+
+  template <typename Allocator>
+  class iovec_array;
+
   struct stop_operation : operation_base {
     stop_operation() noexcept {
       this->execute_ = [](operation_base * op) noexcept {
@@ -86,7 +248,25 @@ class io_uring_context {
     bool shouldStop_ = false;
   };
 
-  using time_point = linux::monotonic_clock::time_point;
+  // Starts an operation from inside the run loop.
+  template <typename Operation>
+  struct start_operation : operation_base {
+    explicit start_operation(Operation& op) noexcept : op_(op) {
+      this->execute_ = [](operation_base* op) noexcept {
+        cpo::start(static_cast<start_operation*>(op)->op_);
+      };
+    }
+    Operation& op_;
+  };
+
+  struct sync_wait_wake_up {
+    io_uring_context& context_;
+    stop_operation& stopOp_;
+
+    void operator()() noexcept {
+      context_.schedule_impl(&stopOp_);
+    }
+  };
 
   struct schedule_at_operation : operation_base {
     explicit schedule_at_operation(
@@ -97,8 +277,10 @@ class io_uring_context {
           dueTime_(dueTime),
           canBeCancelled_(canBeCancelled) {}
 
+    schedule_at_operation* timerChild_;
     schedule_at_operation* timerNext_;
     schedule_at_operation* timerPrev_;
+    schedule_at_operation** timerPrevNextPtr_;
     io_uring_context& context_;
     time_point dueTime_;
     bool canBeCancelled_;
@@ -113,11 +295,19 @@ class io_uring_context {
 
   using timer_heap = intrusive_heap<
       schedule_at_operation,
+      &schedule_at_operation::timerChild_,
       &schedule_at_operation::timerNext_,
       &schedule_at_operation::timerPrev_,
       time_point,
       &schedule_at_operation::dueTime_>;
 
+  using timer_wheel = intrusive_timing_wheel<
+      schedule_at_operation,
+      &schedule_at_operation::timerNext_,
+      &schedule_at_operation::timerPrevNextPtr_,
+      time_point,
+      &schedule_at_operation::dueTime_>;
+
   bool is_running_on_io_thread() const noexcept;
   void run_impl(const bool& shouldStop);
 
@@ -148,19 +338,23 @@ class io_uring_context {
   // to the local queue.
   void acquire_remote_queued_items() noexcept;
 
-  // Submit a request to the submission queue containing an IORING_OP_POLL_ADD
-  // for the remote queue eventfd as a way of registering for asynchronous
-  // notification of someone enqueueing
+  // Mark the remote queue as inactive so that the next thread to enqueue
+  // work wakes up the I/O thread. Submits an IORING_OP_POLL_ADD for the
+  // remote queue eventfd if one is not already armed.
   //
   // Returns true if successful. If so then it is no longer permitted
-  // to call 'acquire_remote_queued_items()' until after the completion
-  // for this POLL_ADD operation is received.
+  // to call 'acquire_remote_queued_items()' until after a wakeup
+  // has been received.
   //
   // Returns false if either no more operations can be submitted at this
   // time (submission queue full or too many pending completions) or if
   // some other thread concurrently enqueued work to the remote queue.
   bool try_register_remote_queue_notification() noexcept;
 
+  // Handle a completion that may wake up the I/O thread after it marked
+  // the remote queue as inactive.
+  void on_remote_queue_wakeup() noexcept;
+
   // Signal the remote queue eventfd.
   //
   // This should only be called after trying to enqueue() work
@@ -168,6 +362,20 @@ class io_uring_context {
   // inactive.
   void signal_remote_queue();
 
+  // As signal_remote_queue() but returns the errno value if the eventfd
+  // could not be written rather than throwing.
+  int try_signal_remote_queue() noexcept;
+
+  // Wake up the I/O thread of 'target' by submitting an IORING_OP_MSG_RING
+  // on this context's ring, which posts a completion directly to the
+  // target's ring. Avoids the eventfd write and read.
+  //
+  // Must be called on this context's I/O thread under the same conditions
+  // as signal_remote_queue(). Returns false if the two contexts are not in
+  // the same wakeup group or the message could not be submitted, in which
+  // case the caller should signal the eventfd instead.
+  bool try_submit_remote_queue_wakeup(io_uring_context& target) noexcept;
+
   void remove_timer(schedule_at_operation* op) noexcept;
   void update_timers() noexcept;
   bool try_submit_timer_io(const time_point& dueTime) noexcept;
@@ -179,12 +387,93 @@ class io_uring_context {
   template <typename PopulateFn>
   bool try_submit_io(PopulateFn populateSqe) noexcept;
 
+  // Try to submit a pair of entries to the submission queue with the
+  // first linked to the second (IOSQE_IO_LINK).
+  //
+  // Either both entries are submitted or neither is.
+  template <typename PopulateFn, typename PopulateLinkedFn>
+  bool try_submit_linked_io(
+      PopulateFn populateSqe,
+      PopulateLinkedFn populateLinkedSqe) noexcept;
+
   // Total number of operations submitted that have not yet
   // completed.
   std::uint32_t pending_operation_count() const noexcept {
     return cqPendingCount_ + sqUnflushedCount_;
   }
 
+  // When the kernel is polling the submission queue, account for the
+  // submission entries that the kernel thread has consumed since last
+  // checked, moving them from the unflushed count to the pending count.
+  void update_consumed_submissions() noexcept;
+
+  // Submit any entries in the submission queue to the kernel without
+  // waiting for completions.
+  void flush_submissions();
+
+  // Owns a slot in the context's table of registered files.
+  class fixed_file_slot {
+   public:
+    fixed_file_slot() noexcept = default;
+
+    explicit fixed_file_slot(io_uring_context& context, int fd)
+      : context_(&context), index_(context.register_file(fd)) {}
+
+    fixed_file_slot(fixed_file_slot&& other) noexcept
+      : context_(std::exchange(other.context_, nullptr)),
+        index_(other.index_) {}
+
+    ~fixed_file_slot() {
+      if (context_ != nullptr) {
+        context_->unregister_file(index_);
+      }
+    }
+
+    fixed_file_slot& operator=(fixed_file_slot other) noexcept {
+      std::swap(context_, other.context_);
+      std::swap(index_, other.index_);
+      return *this;
+    }
+
+    bool valid() const noexcept {
+      return context_ != nullptr;
+    }
+
+    std::uint32_t index() const noexcept {
+      return index_;
+    }
+
+   private:
+    io_uring_context* context_ = nullptr;
+    std::uint32_t index_ = 0;
+  };
+
+  // Look up the index of the registered buffer that entirely contains
+  // the specified range of memory. Returns -1 if there is no such buffer.
+  int find_registered_buffer(const void* data, std::size_t size) const
+      noexcept {
+    // Most contexts have no buffers registered, so don't scan the table.
+    if (registeredBufferCount_.load(std::memory_order_acquire) == 0) {
+      return -1;
+    }
+
+    const auto begin = reinterpret_cast<std::uintptr_t>(data);
+    const std::uint32_t end =
+        registeredBufferEnd_.load(std::memory_order_acquire);
+    for (std::uint32_t i = 0; i < end; ++i) {
+      const auto& slot = registeredBuffers_[i];
+      const auto slotBegin = slot.begin_.load(std::memory_order_acquire);
+      if (slotBegin != 0 && begin >= slotBegin) {
+        const auto slotSize = slot.size_.load(std::memory_order_relaxed);
+        const auto offset = begin - slotBegin;
+        if (offset <= slotSize && size <= slotSize - offset) {
+          return static_cast<int>(i);
+        }
+      }
+    }
+    return -1;
+  }
+
   // Query whether there is space in the submission ring buffer
   // and space in the completion ring buffer for an additional
   // entry.
@@ -201,11 +490,33 @@ class io_uring_context {
     return reinterpret_cast<std::uintptr_t>(&currentDueTime_);
   }
 
+  std::uintptr_t cancel_user_data() const {
+    return reinterpret_cast<std::uintptr_t>(&pendingIoQueue_);
+  }
+
+  std::uintptr_t link_timeout_user_data() const {
+    return reinterpret_cast<std::uintptr_t>(&localQueue_);
+  }
+
   struct __kernel_timespec {
     int64_t tv_sec;
     long long tv_nsec;
   };
 
+  static std::optional<__kernel_timespec> to_kernel_timespec(
+      const std::optional<time_point>& time) noexcept {
+    if (!time) {
+      return std::nullopt;
+    }
+    return __kernel_timespec{time->seconds_part(), time->nanoseconds_part()};
+  }
+
+  // Whether the absolute CLOCK_MONOTONIC time 'deadline' has passed.
+  static bool has_passed(const __kernel_timespec& deadline) noexcept {
+    return time_point::from_seconds_and_nanoseconds(
+               deadline.tv_sec, deadline.tv_nsec) <= monotonic_clock::now();
+  }
+
   ////////
   // Data that does not change once initialised.
 
@@ -227,6 +538,15 @@ class io_uring_context {
   const std::atomic<unsigned>* cqTail_;
   const std::atomic<unsigned>* cqOverflow_;
 
+  // Whether the kernel is polling the submission queue (IORING_SETUP_SQPOLL).
+  bool submissionQueuePolling_ = false;
+
+  // Whether the kernel supports IORING_OP_MSG_RING.
+  bool messageRingSupported_ = false;
+
+  // See options::wakeupGroup.
+  const void* wakeupGroup_ = nullptr;
+
   // Resources
   safe_file_descriptor iouringFd_;
   safe_file_descriptor remoteQueueEventFd_;
@@ -246,6 +566,9 @@ class io_uring_context {
   // Set of operations waiting to be executed at a specific time.
   timer_heap timers_;
 
+  // Used in place of 'timers_' if the timing wheel backend was selected.
+  std::optional<timer_wheel> timerWheel_;
+
   // The time that the current timer operation submitted to the kernel
   // is due to elapse.
   std::optional<time_point> currentDueTime_;
@@ -258,18 +581,51 @@ class io_uring_context {
   // we don't end up with an overflowed completion queue.
   std::uint32_t cqPendingCount_ = 0;
 
-  bool remoteQueueReadSubmitted_ = false;
+  // The remote queue has been marked as inactive and we are waiting to be
+  // woken up before checking it again.
+  bool remoteQueueInactive_ = false;
+
+  // There is an IORING_OP_POLL_ADD outstanding for the remote queue eventfd.
+  bool remoteQueuePollArmed_ = false;
+
+  // Whether to use a multishot poll for the remote queue eventfd, which
+  // stays armed across wakeups. Cleared if the kernel doesn't support it.
+  bool remoteQueuePollMultishot_ = true;
+
   bool timersAreDirty_ = false;
 
   std::uint32_t activeTimerCount_ = 0;
 
   __kernel_timespec time_;
 
+  // Copy of pending_operation_count() that other threads may read.
+  std::atomic<std::uint32_t> pendingIoCountEstimate_{0};
+
   //////////////////
   // Data that is modified by remote threads
 
   // Queue of operations enqueued by remote threads.
   atomic_intrusive_queue<operation_base, &operation_base::next_> remoteQueue_;
+
+  // Table of registered buffers, indexed by the buffer's slot.
+  // A slot with a zero begin_ address is free. Slots are only assigned
+  // while holding registeredBuffersMutex_ but are read without the lock
+  // by the I/O thread.
+  struct registered_buffer {
+    std::atomic<std::uintptr_t> begin_{0};
+    std::atomic<std::size_t> size_{0};
+  };
+  std::uint32_t registeredBufferSlotCount_ = 0;
+  std::unique_ptr<registered_buffer[]> registeredBuffers_;
+  // The number of slots in use, and one past the highest one in use, so
+  // that lookups only scan the part of the table that can match.
+  std::atomic<std::uint32_t> registeredBufferCount_{0};
+  std::atomic<std::uint32_t> registeredBufferEnd_{0};
+  std::mutex registeredBuffersMutex_;
+
+  // Indices of the unused slots in the table of registered files.
+  std::vector<std::uint32_t> freeFileSlots_;
+  std::mutex registeredFilesMutex_;
 };
 
 template <typename StopToken>
@@ -281,6 +637,27 @@ void io_uring_context::run(StopToken stopToken) {
   run_impl(stopOp.shouldStop_);
 }
 
+template <typename Sender, typename StopToken, typename Result>
+std::optional<Result> io_uring_context::sync_wait(
+    Sender&& sender,
+    StopToken&& st) {
+  detail::loop_sync_wait_promise<Result> promise;
+  stop_operation stopOp;
+
+  auto op = cpo::connect(
+      (Sender &&) sender,
+      detail::loop_sync_wait_receiver<Result, StopToken&&, sync_wait_wake_up>{
+          promise, (StopToken &&) st, sync_wait_wake_up{*this, stopOp}});
+
+  // Nothing else runs the loop so we can queue this directly.
+  start_operation<decltype(op)> startOp{op};
+  schedule_local(&startOp);
+
+  run_impl(stopOp.shouldStop_);
+
+  return std::move(promise).get();
+}
+
 template <typename PopulateFn>
 bool io_uring_context::try_submit_io(PopulateFn populateSqe) noexcept {
   assert(is_running_on_io_thread());
@@ -296,6 +673,11 @@ bool io_uring_context::try_submit_io(PopulateFn populateSqe) noexcept {
       const auto index = tail & sqMask_;
       auto& sqe = sqEntries_[index];
 
+      // Start from a zeroed entry so that populateSqe() only needs to fill
+      // in the fields relevant to the operation. The layout of the trailing
+      // fields of io_uring_sqe varies between kernel versions.
+      std::memset(&sqe, 0, sizeof(sqe));
+
       static_assert(noexcept(populateSqe(sqe)));
 
       if constexpr (std::is_void_v<decltype(populateSqe(sqe))>) {
@@ -316,6 +698,50 @@ bool io_uring_context::try_submit_io(PopulateFn populateSqe) noexcept {
   return false;
 }
 
+template <typename PopulateFn, typename PopulateLinkedFn>
+bool io_uring_context::try_submit_linked_io(
+    PopulateFn populateSqe,
+    PopulateLinkedFn populateLinkedSqe) noexcept {
+  assert(is_running_on_io_thread());
+
+  // Both entries produce a completion.
+  if (pending_operation_count() + 2 > cqEntryCount_) {
+    return false;
+  }
+
+  const auto tail = sqTail_->load(std::memory_order_relaxed);
+  const auto head = sqHead_->load(std::memory_order_acquire);
+  const auto usedCount = (tail - head);
+  assert(usedCount <= sqEntryCount_);
+  if (usedCount + 2 > sqEntryCount_) {
+    return false;
+  }
+
+  const auto index = tail & sqMask_;
+  const auto linkedIndex = (tail + 1) & sqMask_;
+  auto& sqe = sqEntries_[index];
+  auto& linkedSqe = sqEntries_[linkedIndex];
+
+  std::memset(&sqe, 0, sizeof(sqe));
+  std::memset(&linkedSqe, 0, sizeof(linkedSqe));
+
+  static_assert(noexcept(populateSqe(sqe)));
+  static_assert(noexcept(populateLinkedSqe(linkedSqe)));
+
+  populateSqe(sqe);
+  populateLinkedSqe(linkedSqe);
+  sqe.flags |= IOSQE_IO_LINK;
+
+  sqIndexArray_[index] = index;
+  sqIndexArray_[linkedIndex] = linkedIndex;
+
+  // Publish both entries at once so that the kernel never sees the first
+  // entry without the entry it is linked to.
+  sqTail_->store(tail + 2, std::memory_order_release);
+  sqUnflushedCount_ += 2;
+  return true;
+}
+
 class io_uring_context::schedule_sender {
   template <typename Receiver>
   class operation : private operation_base {
@@ -378,83 +804,324 @@ class io_uring_context::schedule_sender {
   io_uring_context& context_;
 };
 
+// Base for operations that submit a single SQE and produce their result
+// from the result of that SQE.
+//
+// Derived must provide the following, which may be private if Derived
+// befriends this class:
+//   void populate_sqe(io_uring_sqe& sqe) noexcept;
+//   void complete_with_result(int result) noexcept;
+// complete_with_result() is only called with a non-negative result.
+// Other results complete with set_done() if the operation was cancelled
+// or set_error() otherwise.
+//
+// If Cancellable is true and the receiver's stop token can be stopped then
+// requesting stop before the SQE is submitted completes the operation with
+// set_done() without submitting it. Requesting stop once the SQE has been
+// submitted submits an IORING_OP_ASYNC_CANCEL for it.
+//
+// Derived may also provide
+//   const __kernel_timespec* deadline() const noexcept;
+// returning an absolute CLOCK_MONOTONIC time. If non-null the SQE is linked
+// to an IORING_OP_LINK_TIMEOUT and the operation fails with
+// std::errc::timed_out if it has not completed by then. Other cancellations
+// by the kernel complete with set_done().
+template <typename Derived, typename Receiver, bool Cancellable>
+class io_uring_context::io_operation : protected completion_base {
+  friend io_uring_context;
+
+  static constexpr bool is_stop_ever_possible = Cancellable &&
+      !is_stop_never_possible_v<stop_token_type_t<Receiver>>;
+
+ public:
+  void start() noexcept {
+    if constexpr (is_stop_ever_possible) {
+      if (get_stop_token(receiver_).stop_requested()) {
+        // Stop already requested. Don't bother submitting the I/O.
+        this->execute_ = &io_operation::complete_with_done;
+        context_.schedule_impl(this);
+        return;
+      }
+      stopCallback_.construct(
+          get_stop_token(receiver_), cancel_callback{*this});
+    }
+
+    if (!context_.is_running_on_io_thread()) {
+      this->execute_ = &io_operation::on_schedule_complete;
+      context_.schedule_remote(this);
+    } else {
+      start_io();
+    }
+  }
+
+ protected:
+  template <typename Receiver2>
+  explicit io_operation(io_uring_context& context, Receiver2&& r)
+      : context_(context), receiver_((Receiver2 &&) r), cancelState_(this) {}
+
+  // Operations have no deadline unless Derived hides this.
+  const __kernel_timespec* deadline() const noexcept {
+    return nullptr;
+  }
+
+  io_uring_context& context_;
+  Receiver receiver_;
+
+ private:
+  static void on_schedule_complete(operation_base* op) noexcept {
+    static_cast<io_operation*>(op)->start_io();
+  }
+
+  void start_io() noexcept {
+    assert(context_.is_running_on_io_thread());
+
+    if constexpr (is_stop_ever_possible) {
+      if (cancelState_.cancelled_) {
+        // The cancellation ran before we got to submit the I/O.
+        stopCallback_.destruct();
+        complete_with_done(this);
+        return;
+      }
+    }
+
+    auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
+      static_cast<Derived*>(this)->populate_sqe(sqe);
+      sqe.user_data = reinterpret_cast<std::uintptr_t>(
+          static_cast<completion_base*>(this));
+
+      this->execute_ = &io_operation::on_complete;
+    };
+
+    bool submitted;
+    if (auto* deadline = static_cast<const Derived*>(this)->deadline()) {
+      auto populateLinkTimeoutSqe = [&](io_uring_sqe & sqe) noexcept {
+        sqe.opcode = IORING_OP_LINK_TIMEOUT;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(deadline);
+        sqe.len = 1;
+        sqe.timeout_flags = IORING_TIMEOUT_ABS;
+        sqe.user_data = context_.link_timeout_user_data();
+      };
+      submitted =
+          context_.try_submit_linked_io(populateSqe, populateLinkTimeoutSqe);
+    } else {
+      submitted = context_.try_submit_io(populateSqe);
+    }
+
+    if (submitted) {
+      if constexpr (is_stop_ever_possible) {
+        cancelState_.submitted_ = true;
+      }
+    } else {
+      this->execute_ = &io_operation::on_schedule_complete;
+      context_.schedule_pending_io(this);
+    }
+  }
+
+  static void on_complete(operation_base* op) noexcept {
+    auto& self = *static_cast<io_operation*>(op);
+
+    if constexpr (is_stop_ever_possible) {
+      // Once this returns the stop callback is guaranteed to have either
+      // not run or have finished scheduling the cancel operation.
+      self.stopCallback_.destruct();
+      self.cancelState_.ioCompleted_ = true;
+
+      const bool cancelPending =
+          self.cancelState_.cancelRequested_.load(std::memory_order_acquire) &&
+          !self.cancelState_.cancelled_;
+      if (cancelPending) {
+        // The cancel operation still references this operation.
+        // Let it deliver the result when it runs.
+        return;
+      }
+    }
+
+    self.deliver_result();
+  }
+
+  void deliver_result() noexcept {
+    if (this->result_ >= 0) {
+      static_cast<Derived&>(*this).complete_with_result(this->result_);
+    } else if (stop_was_requested()) {
+      cpo::set_done(std::move(receiver_));
+    } else if (this->result_ == -ECANCELED) {
+      // The kernel cancels operations for other reasons too, e.g. when the
+      // ring is torn down, so only report a timeout once the deadline has
+      // actually passed.
+      auto* deadline = static_cast<const Derived&>(*this).deadline();
+      if (deadline != nullptr && has_passed(*deadline)) {
+        // Cancelled by the linked timeout.
+        cpo::set_error(
+            std::move(receiver_),
+            std::make_error_code(std::errc::timed_out));
+      } else {
+        cpo::set_done(std::move(receiver_));
+      }
+    } else {
+      cpo::set_error(
+          std::move(receiver_),
+          std::error_code{-this->result_, std::system_category()});
+    }
+  }
+
+  bool stop_was_requested() const noexcept {
+    if constexpr (is_stop_ever_possible) {
+      return cancelState_.cancelRequested_.load(std::memory_order_relaxed);
+    } else {
+      return false;
+    }
+  }
+
+  static void complete_with_done(operation_base* op) noexcept {
+    // Avoid instantiating set_done() if we're never going to call it.
+    if constexpr (is_stop_ever_possible) {
+      auto& self = *static_cast<io_operation*>(op);
+      cpo::set_done(std::move(self.receiver_));
+    } else {
+      assert(false);
+    }
+  }
+
+  struct cancel_callback {
+    io_operation& op_;
+
+    void operator()() noexcept {
+      op_.cancelState_.cancelRequested_.store(true, std::memory_order_release);
+      op_.context_.schedule_impl(&op_.cancelState_.cancelOp_);
+    }
+  };
+
+  // Executed on the I/O thread after stop has been requested.
+  static void on_cancel(operation_base* cancelOp) noexcept {
+    if constexpr (is_stop_ever_possible) {
+      auto& self = *static_cast<cancel_operation*>(cancelOp)->op_;
+      assert(self.context_.is_running_on_io_thread());
+
+      if (self.cancelState_.ioCompleted_) {
+        // The I/O completed before we got to cancel it.
+        self.cancelState_.cancelled_ = true;
+        self.deliver_result();
+        return;
+      }
+
+      if (!self.cancelState_.submitted_) {
+        // Still waiting to be submitted. start_io() will complete it.
+        self.cancelState_.cancelled_ = true;
+        return;
+      }
+
+      auto populateSqe = [&self](io_uring_sqe & sqe) noexcept {
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(
+            static_cast<completion_base*>(&self));
+        sqe.user_data = self.context_.cancel_user_data();
+      };
+
+      if (self.context_.try_submit_io(populateSqe)) {
+        self.cancelState_.cancelled_ = true;
+      } else {
+        // No space for the cancellation. Try again later.
+        self.context_.schedule_pending_io(&self.cancelState_.cancelOp_);
+      }
+    } else {
+      (void)cancelOp;
+      assert(false);
+    }
+  }
+
+  struct cancel_operation : operation_base {
+    explicit cancel_operation(io_operation* op) noexcept : op_(op) {
+      this->execute_ = &io_operation::on_cancel;
+    }
+    io_operation* op_;
+  };
+
+  struct cancel_state {
+    explicit cancel_state(io_operation* op) noexcept : cancelOp_(op) {}
+
+    cancel_operation cancelOp_;
+    std::atomic<bool> cancelRequested_{false};
+
+    // Only accessed from the I/O thread.
+    bool submitted_ = false;
+    bool ioCompleted_ = false;
+    bool cancelled_ = false;
+  };
+
+  struct no_cancel_state {
+    explicit no_cancel_state(io_operation*) noexcept {}
+  };
+  struct no_stop_callback {};
+
+  UNIFEX_NO_UNIQUE_ADDRESS
+  std::conditional_t<is_stop_ever_possible, cancel_state, no_cancel_state>
+      cancelState_;
+
+  UNIFEX_NO_UNIQUE_ADDRESS
+  std::conditional_t<
+      is_stop_ever_possible,
+      manual_lifetime<typename stop_token_type_t<
+          Receiver>::template callback_type<cancel_callback>>,
+      no_stop_callback>
+      stopCallback_;
+};
+
 class io_uring_context::read_sender {
   using offset_t = std::uint64_t;
 
   template <typename Receiver>
-  class operation : private completion_base {
-    friend io_uring_context;
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
 
    public:
     template <typename Receiver2>
     explicit operation(const read_sender& sender, Receiver2&& r)
-        : context_(sender.context_),
+        : base(sender.context_, (Receiver2 &&) r),
           fd_(sender.fd_),
+          fixedFile_(sender.fixedFile_),
           offset_(sender.offset_),
-          receiver_((Receiver2 &&) r) {
+          deadline_(to_kernel_timespec(sender.deadline_)) {
       buffer_[0].iov_base = sender.buffer_.data();
       buffer_[0].iov_len = sender.buffer_.size();
     }
 
-    void start() noexcept {
-      if (!context_.is_running_on_io_thread()) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_remote(this);
-      } else {
-        start_io();
-      }
-    }
-
    private:
-    void populate_sqe(io_uring_sqe& sqe) noexcept {}
-
-    static void on_schedule_complete(operation_base* op) noexcept {
-      static_cast<operation*>(op)->start_io();
+    const __kernel_timespec* deadline() const noexcept {
+      return deadline_ ? &*deadline_ : nullptr;
     }
 
-    void start_io() noexcept {
-      assert(context_.is_running_on_io_thread());
-
-      auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      const int bufferIndex = this->context_.find_registered_buffer(
+          buffer_[0].iov_base, buffer_[0].iov_len);
+
+      sqe.flags = fixedFile_ ? IOSQE_FIXED_FILE : 0;
+      sqe.ioprio = 0;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      if (bufferIndex >= 0) {
+        sqe.opcode = IORING_OP_READ_FIXED;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(buffer_[0].iov_base);
+        sqe.len = buffer_[0].iov_len;
+        sqe.buf_index = bufferIndex;
+      } else {
         sqe.opcode = IORING_OP_READV;
-        sqe.flags = 0;
-        sqe.ioprio = 0;
-        sqe.fd = fd_;
-        sqe.off = offset_;
         sqe.addr = reinterpret_cast<std::uintptr_t>(&buffer_[0]);
         sqe.len = 1;
-        sqe.rw_flags = 0;
-        sqe.user_data = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(this));
-        sqe.__pad2[0] = sqe.__pad2[1] = sqe.__pad2[2] = 0;
-
-        this->execute_ = &operation::on_read_complete;
-      };
-
-      if (!context_.try_submit_io(populateSqe)) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_pending_io(this);
       }
+      sqe.rw_flags = 0;
     }
 
-    static void on_read_complete(operation_base* op) noexcept {
-      auto& self = *static_cast<operation*>(op);
-      if (self.result_ >= 0) {
-        cpo::set_value(std::move(self.receiver_), ssize_t(self.result_));
-      } else if (self.result_ == -ECANCELED) {
-        cpo::set_done(std::move(self.receiver_));
-      } else {
-        cpo::set_error(
-            std::move(self.receiver_),
-            std::error_code{-self.result_, std::system_category()});
-      }
+    void complete_with_result(int result) noexcept {
+      cpo::set_value(std::move(this->receiver_), ssize_t(result));
     }
 
-    io_uring_context& context_;
     int fd_;
+    bool fixedFile_;
     offset_t offset_;
     iovec buffer_[1];
-    Receiver receiver_;
+    std::optional<__kernel_timespec> deadline_;
   };
 
  public:
@@ -467,12 +1134,24 @@ class io_uring_context::read_sender {
   template <template <typename...> class Variant>
   using error_types = Variant<std::error_code>;
 
+  // If fixedFile is true then 'fd' is the index of a slot in the context's
+  // table of registered files rather than a file descriptor.
+  //
+  // If a deadline is given then the operation fails with
+  // std::errc::timed_out if it has not completed by then.
   explicit read_sender(
       io_uring_context& context,
       int fd,
       offset_t offset,
-      span<std::byte> buffer) noexcept
-      : context_(context), fd_(fd), offset_(offset), buffer_(buffer) {}
+      span<std::byte> buffer,
+      bool fixedFile = false,
+      std::optional<time_point> deadline = std::nullopt) noexcept
+      : context_(context),
+        fd_(fd),
+        fixedFile_(fixedFile),
+        offset_(offset),
+        buffer_(buffer),
+        deadline_(deadline) {}
 
   template <typename Receiver>
   operation<std::decay_t<Receiver>> connect(Receiver&& r) {
@@ -482,87 +1161,68 @@ class io_uring_context::read_sender {
  private:
   io_uring_context& context_;
   int fd_;
+  bool fixedFile_;
   offset_t offset_;
   span<std::byte> buffer_;
+  std::optional<time_point> deadline_;
 };
 
 class io_uring_context::write_sender {
   using offset_t = std::uint64_t;
 
   template <typename Receiver>
-  class operation : private completion_base {
-    friend io_uring_context;
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
 
    public:
     template <typename Receiver2>
     explicit operation(const write_sender& sender, Receiver2&& r)
-        : context_(sender.context_),
+        : base(sender.context_, (Receiver2 &&) r),
           fd_(sender.fd_),
+          fixedFile_(sender.fixedFile_),
           offset_(sender.offset_),
-          receiver_((Receiver2 &&) r) {
+          deadline_(to_kernel_timespec(sender.deadline_)) {
       buffer_[0].iov_base = (void*)sender.buffer_.data();
       buffer_[0].iov_len = sender.buffer_.size();
     }
 
-    void start() noexcept {
-      if (!context_.is_running_on_io_thread()) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_remote(this);
-      } else {
-        start_io();
-      }
-    }
-
    private:
-    void populate_sqe(io_uring_sqe& sqe) noexcept {}
-
-    static void on_schedule_complete(operation_base* op) noexcept {
-      static_cast<operation*>(op)->start_io();
+    const __kernel_timespec* deadline() const noexcept {
+      return deadline_ ? &*deadline_ : nullptr;
     }
 
-    void start_io() noexcept {
-      assert(context_.is_running_on_io_thread());
-
-      auto populateSqe = [this](io_uring_sqe & sqe) noexcept {
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      const int bufferIndex = this->context_.find_registered_buffer(
+          buffer_[0].iov_base, buffer_[0].iov_len);
+
+      sqe.flags = fixedFile_ ? IOSQE_FIXED_FILE : 0;
+      sqe.ioprio = 0;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      if (bufferIndex >= 0) {
+        sqe.opcode = IORING_OP_WRITE_FIXED;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(buffer_[0].iov_base);
+        sqe.len = buffer_[0].iov_len;
+        sqe.buf_index = bufferIndex;
+      } else {
         sqe.opcode = IORING_OP_WRITEV;
-        sqe.flags = 0;
-        sqe.ioprio = 0;
-        sqe.fd = fd_;
-        sqe.off = offset_;
         sqe.addr = reinterpret_cast<std::uintptr_t>(&buffer_[0]);
         sqe.len = 1;
-        sqe.rw_flags = 0;
-        sqe.user_data = reinterpret_cast<std::uintptr_t>(
-            static_cast<completion_base*>(this));
-        sqe.__pad2[0] = sqe.__pad2[1] = sqe.__pad2[2] = 0;
-
-        this->execute_ = &operation::on_write_complete;
-      };
-
-      if (!context_.try_submit_io(populateSqe)) {
-        this->execute_ = &operation::on_schedule_complete;
-        context_.schedule_pending_io(this);
       }
+      sqe.rw_flags = 0;
     }
 
-    static void on_write_complete(operation_base* op) noexcept {
-      auto& self = *static_cast<operation*>(op);
-      if (self.result_ >= 0) {
-        cpo::set_value(std::move(self.receiver_), ssize_t(self.result_));
-      } else if (self.result_ == -ECANCELED) {
-        cpo::set_done(std::move(self.receiver_));
-      } else {
-        cpo::set_error(
-            std::move(self.receiver_),
-            std::error_code{-self.result_, std::system_category()});
-      }
+    void complete_with_result(int result) noexcept {
+      cpo::set_value(std::move(this->receiver_), ssize_t(result));
     }
 
-    io_uring_context& context_;
     int fd_;
+    bool fixedFile_;
     offset_t offset_;
     iovec buffer_[1];
-    Receiver receiver_;
+    std::optional<__kernel_timespec> deadline_;
   };
 
  public:
@@ -575,12 +1235,24 @@ class io_uring_context::write_sender {
   template <template <typename...> class Variant>
   using error_types = Variant<std::error_code>;
 
+  // If fixedFile is true then 'fd' is the index of a slot in the context's
+  // table of registered files rather than a file descriptor.
+  //
+  // If a deadline is given then the operation fails with
+  // std::errc::timed_out if it has not completed by then.
   explicit write_sender(
       io_uring_context& context,
       int fd,
       offset_t offset,
-      span<const std::byte> buffer) noexcept
-      : context_(context), fd_(fd), offset_(offset), buffer_(buffer) {}
+      span<const std::byte> buffer,
+      bool fixedFile = false,
+      std::optional<time_point> deadline = std::nullopt) noexcept
+      : context_(context),
+        fd_(fd),
+        fixedFile_(fixedFile),
+        offset_(offset),
+        buffer_(buffer),
+        deadline_(deadline) {}
 
   template <typename Receiver>
   operation<std::decay_t<Receiver>> connect(Receiver&& r) {
@@ -590,67 +1262,833 @@ class io_uring_context::write_sender {
  private:
   io_uring_context& context_;
   int fd_;
+  bool fixedFile_;
   offset_t offset_;
   span<const std::byte> buffer_;
+  std::optional<time_point> deadline_;
 };
 
-class io_uring_context::async_read_only_file {
+// The iovec array for a vectored read or write. Short sequences of buffers
+// are stored inline in the operation state; longer ones are allocated using
+// the receiver's allocator.
+template <typename Allocator>
+class io_uring_context::iovec_array {
+  using allocator_traits = std::allocator_traits<Allocator>;
+
  public:
-  using offset_t = std::uint64_t;
+  static constexpr std::size_t inline_capacity = 8;
+
+  explicit iovec_array(std::size_t size, const Allocator& alloc)
+      : allocator_(alloc), size_(size) {
+    if (size_ > inline_capacity) {
+      data_ = allocator_traits::allocate(allocator_, size_);
+    } else {
+      data_ = inline_;
+    }
+  }
 
-  explicit async_read_only_file(io_uring_context& context, int fd) noexcept
-      : context_(context), fd_(fd) {}
+  iovec_array(iovec_array&&) = delete;
 
-  read_sender async_read_some(
-      uint64_t offset,
-      span<std::byte> buffer) noexcept {
-    return read_sender{context_, fd_.get(), offset, buffer};
+  ~iovec_array() {
+    if (data_ != inline_) {
+      allocator_traits::deallocate(allocator_, data_, size_);
+    }
   }
 
- private:
-  friend scheduler;
+  iovec* data() noexcept {
+    return data_;
+  }
 
-  friend read_sender tag_invoke(
-      tag_t<async_read_some_at>,
-      async_read_only_file& file,
-      offset_t offset,
-      span<std::byte> buffer) noexcept {
-    return read_sender{file.context_, file.fd_.get(), offset, buffer};
+  std::size_t size() const noexcept {
+    return size_;
   }
 
-  io_uring_context& context_;
-  safe_file_descriptor fd_;
+ private:
+  UNIFEX_NO_UNIQUE_ADDRESS Allocator allocator_;
+  std::size_t size_;
+  iovec* data_;
+  iovec inline_[inline_capacity];
 };
 
-class io_uring_context::async_write_only_file {
- public:
+// A vectored read that reads into each of the buffers of a BufferSequence in
+// turn with a single IORING_OP_READV.
+template <typename BufferSequence>
+class io_uring_context::readv_sender {
   using offset_t = std::uint64_t;
 
-  explicit async_write_only_file(io_uring_context& context, int fd) noexcept
-      : context_(context), fd_(fd) {}
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
 
- private:
-  friend scheduler;
+    using allocator_t = typename std::allocator_traits<
+        get_allocator_t<const Receiver&>>::template rebind_alloc<iovec>;
 
-  friend write_sender tag_invoke(
-      tag_t<async_write_some_at>,
-      async_write_only_file& file,
-      offset_t offset,
-      span<const std::byte> buffer) noexcept {
-    return write_sender{file.context_, file.fd_.get(), offset, buffer};
-  }
+   public:
+    template <typename Receiver2>
+    explicit operation(const readv_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r),
+          fd_(sender.fd_),
+          fixedFile_(sender.fixedFile_),
+          offset_(sender.offset_),
+          buffers_(
+              static_cast<std::size_t>(std::distance(
+                  std::begin(sender.buffers_), std::end(sender.buffers_))),
+              allocator_t(get_allocator(this->receiver_))),
+          deadline_(to_kernel_timespec(sender.deadline_)) {
+      iovec* out = buffers_.data();
+      for (span<std::byte> buffer : sender.buffers_) {
+        out->iov_base = buffer.data();
+        out->iov_len = buffer.size();
+        ++out;
+      }
+    }
 
+   private:
+    const __kernel_timespec* deadline() const noexcept {
+      return deadline_ ? &*deadline_ : nullptr;
+    }
+
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      sqe.opcode = IORING_OP_READV;
+      sqe.flags = fixedFile_ ? IOSQE_FIXED_FILE : 0;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(buffers_.data());
+      sqe.len = static_cast<std::uint32_t>(buffers_.size());
+    }
+
+    void complete_with_result(int result) noexcept {
+      cpo::set_value(std::move(this->receiver_), ssize_t(result));
+    }
+
+    int fd_;
+    bool fixedFile_;
+    offset_t offset_;
+    iovec_array<allocator_t> buffers_;
+    std::optional<__kernel_timespec> deadline_;
+  };
+
+ public:
+  // Produces number of bytes read.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  template <typename BufferSequence2>
+  explicit readv_sender(
+      io_uring_context& context,
+      int fd,
+      offset_t offset,
+      BufferSequence2&& buffers,
+      bool fixedFile = false,
+      std::optional<time_point> deadline = std::nullopt)
+      : context_(context),
+        fd_(fd),
+        fixedFile_(fixedFile),
+        offset_(offset),
+        buffers_((BufferSequence2 &&) buffers),
+        deadline_(deadline) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
   io_uring_context& context_;
-  safe_file_descriptor fd_;
+  int fd_;
+  bool fixedFile_;
+  offset_t offset_;
+  BufferSequence buffers_;
+  std::optional<time_point> deadline_;
+};
+
+// A vectored write that writes from each of the buffers of a BufferSequence in
+// turn with a single IORING_OP_WRITEV.
+template <typename BufferSequence>
+class io_uring_context::writev_sender {
+  using offset_t = std::uint64_t;
+
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
+
+    using allocator_t = typename std::allocator_traits<
+        get_allocator_t<const Receiver&>>::template rebind_alloc<iovec>;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const writev_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r),
+          fd_(sender.fd_),
+          fixedFile_(sender.fixedFile_),
+          offset_(sender.offset_),
+          buffers_(
+              static_cast<std::size_t>(std::distance(
+                  std::begin(sender.buffers_), std::end(sender.buffers_))),
+              allocator_t(get_allocator(this->receiver_))),
+          deadline_(to_kernel_timespec(sender.deadline_)) {
+      iovec* out = buffers_.data();
+      for (span<const std::byte> buffer : sender.buffers_) {
+        out->iov_base = (void*)buffer.data();
+        out->iov_len = buffer.size();
+        ++out;
+      }
+    }
+
+   private:
+    const __kernel_timespec* deadline() const noexcept {
+      return deadline_ ? &*deadline_ : nullptr;
+    }
+
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      sqe.opcode = IORING_OP_WRITEV;
+      sqe.flags = fixedFile_ ? IOSQE_FIXED_FILE : 0;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(buffers_.data());
+      sqe.len = static_cast<std::uint32_t>(buffers_.size());
+    }
+
+    void complete_with_result(int result) noexcept {
+      cpo::set_value(std::move(this->receiver_), ssize_t(result));
+    }
+
+    int fd_;
+    bool fixedFile_;
+    offset_t offset_;
+    iovec_array<allocator_t> buffers_;
+    std::optional<__kernel_timespec> deadline_;
+  };
+
+ public:
+  // Produces number of bytes written.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<ssize_t>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  template <typename BufferSequence2>
+  explicit writev_sender(
+      io_uring_context& context,
+      int fd,
+      offset_t offset,
+      BufferSequence2&& buffers,
+      bool fixedFile = false,
+      std::optional<time_point> deadline = std::nullopt)
+      : context_(context),
+        fd_(fd),
+        fixedFile_(fixedFile),
+        offset_(offset),
+        buffers_((BufferSequence2 &&) buffers),
+        deadline_(deadline) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  bool fixedFile_;
+  offset_t offset_;
+  BufferSequence buffers_;
+  std::optional<time_point> deadline_;
+};
+
+template <typename File>
+class io_uring_context::open_sender {
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const open_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r),
+          path_(sender.path_),
+          flags_(sender.flags_) {}
+
+   private:
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      sqe.opcode = IORING_OP_OPENAT;
+      sqe.fd = AT_FDCWD;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(path_.c_str());
+      sqe.len = 0666; // mode, only used if creating the file
+      sqe.open_flags = flags_;
+    }
+
+    void complete_with_result(int fd) noexcept {
+      cpo::set_value(std::move(this->receiver_), File{this->context_, fd});
+    }
+
+    filesystem::path path_;
+    int flags_;
+  };
+
+ public:
+  // Produces the opened file.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<File>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  explicit open_sender(
+      io_uring_context& context,
+      const filesystem::path& path,
+      int flags)
+      : context_(context), path_(path), flags_(flags) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  filesystem::path path_;
+  int flags_;
+};
+
+class io_uring_context::close_sender {
+  // Closing is not cancellable as the file descriptor would be leaked.
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, false> {
+    using base = io_operation<operation<Receiver>, Receiver, false>;
+    friend base;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const close_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r), file_(sender.file_) {}
+
+    void start() noexcept {
+      fd_ = release_file(file_);
+      base::start();
+    }
+
+   private:
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      sqe.opcode = IORING_OP_CLOSE;
+      sqe.fd = fd_;
+    }
+
+    void complete_with_result(int) noexcept {
+      cpo::set_value(std::move(this->receiver_));
+    }
+
+    async_file_base& file_;
+    int fd_ = -1;
+  };
+
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  explicit close_sender(
+      io_uring_context& context,
+      async_file_base& file) noexcept
+      : context_(context), file_(file) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  // Takes ownership of the file's descriptor. Defined after async_file_base.
+  static int release_file(async_file_base& file) noexcept;
+
+  io_uring_context& context_;
+  async_file_base& file_;
+};
+
+class io_uring_context::statx_sender {
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const statx_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r),
+          fd_(sender.fd_),
+          mask_(sender.mask_) {}
+
+   private:
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      // Query the file itself rather than a path relative to it.
+      static constexpr char emptyPath[] = "";
+
+      sqe.opcode = IORING_OP_STATX;
+      sqe.fd = fd_;
+      sqe.addr = reinterpret_cast<std::uintptr_t>(emptyPath);
+      sqe.len = mask_;
+      sqe.off = reinterpret_cast<std::uintptr_t>(&statx_);
+      sqe.statx_flags = AT_EMPTY_PATH;
+    }
+
+    void complete_with_result(int) noexcept {
+      cpo::set_value(std::move(this->receiver_), statx_);
+    }
+
+    int fd_;
+    unsigned mask_;
+    struct statx statx_;
+  };
+
+ public:
+  // Produces the file's metadata.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<struct statx>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  explicit statx_sender(
+      io_uring_context& context,
+      int fd,
+      unsigned mask = STATX_BASIC_STATS) noexcept
+      : context_(context), fd_(fd), mask_(mask) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  unsigned mask_;
+};
+
+class io_uring_context::fsync_sender {
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const fsync_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r),
+          fd_(sender.fd_),
+          fixedFile_(sender.fixedFile_),
+          fsyncFlags_(sender.fsyncFlags_) {}
+
+   private:
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      sqe.opcode = IORING_OP_FSYNC;
+      sqe.flags = fixedFile_ ? IOSQE_FIXED_FILE : 0;
+      sqe.fd = fd_;
+      sqe.fsync_flags = fsyncFlags_;
+    }
+
+    void complete_with_result(int) noexcept {
+      cpo::set_value(std::move(this->receiver_));
+    }
+
+    int fd_;
+    bool fixedFile_;
+    std::uint32_t fsyncFlags_;
+  };
+
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  // Pass IORING_FSYNC_DATASYNC as 'fsyncFlags' for fdatasync() semantics.
+  explicit fsync_sender(
+      io_uring_context& context,
+      int fd,
+      bool fixedFile,
+      std::uint32_t fsyncFlags) noexcept
+      : context_(context),
+        fd_(fd),
+        fixedFile_(fixedFile),
+        fsyncFlags_(fsyncFlags) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  bool fixedFile_;
+  std::uint32_t fsyncFlags_;
+};
+
+class io_uring_context::fallocate_sender {
+  using offset_t = std::uint64_t;
+
+  template <typename Receiver>
+  class operation
+    : public io_operation<operation<Receiver>, Receiver, true> {
+    using base = io_operation<operation<Receiver>, Receiver, true>;
+    friend base;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(const fallocate_sender& sender, Receiver2&& r)
+        : base(sender.context_, (Receiver2 &&) r),
+          fd_(sender.fd_),
+          fixedFile_(sender.fixedFile_),
+          mode_(sender.mode_),
+          offset_(sender.offset_),
+          length_(sender.length_) {}
+
+   private:
+    void populate_sqe(io_uring_sqe& sqe) noexcept {
+      sqe.opcode = IORING_OP_FALLOCATE;
+      sqe.flags = fixedFile_ ? IOSQE_FIXED_FILE : 0;
+      sqe.fd = fd_;
+      sqe.off = offset_;
+      sqe.addr = length_;
+      sqe.len = mode_;
+    }
+
+    void complete_with_result(int) noexcept {
+      cpo::set_value(std::move(this->receiver_));
+    }
+
+    int fd_;
+    bool fixedFile_;
+    int mode_;
+    offset_t offset_;
+    offset_t length_;
+  };
+
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = Variant<Tuple<>>;
+
+  template <template <typename...> class Variant>
+  using error_types = Variant<std::error_code>;
+
+  explicit fallocate_sender(
+      io_uring_context& context,
+      int fd,
+      bool fixedFile,
+      int mode,
+      offset_t offset,
+      offset_t length) noexcept
+      : context_(context),
+        fd_(fd),
+        fixedFile_(fixedFile),
+        mode_(mode),
+        offset_(offset),
+        length_(length) {}
+
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& r) const {
+    return operation<std::remove_cvref_t<Receiver>>{*this, (Receiver &&) r};
+  }
+
+ private:
+  io_uring_context& context_;
+  int fd_;
+  bool fixedFile_;
+  int mode_;
+  offset_t offset_;
+  offset_t length_;
 };
 
-class io_uring_context::async_read_write_file {
+// State and operations common to all of the file types.
+class io_uring_context::async_file_base {
  public:
   using offset_t = std::uint64_t;
 
-  explicit async_read_write_file(io_uring_context& context, int fd) noexcept
+  // Register the file in a slot of the context's table of registered
+  // files so that subsequent I/O is submitted with IOSQE_FIXED_FILE.
+  // Throws std::system_error if no slot is available.
+  void register_fixed_file() {
+    fixedFile_ = fixed_file_slot{context_, fd_.get()};
+  }
+
+ protected:
+  explicit async_file_base(io_uring_context& context, int fd) noexcept
       : context_(context), fd_(fd) {}
 
+  // The value to use for 'fd' when submitting I/O for this file.
+  int sqe_fd() const noexcept {
+    return fixedFile_.valid() ? static_cast<int>(fixedFile_.index())
+                              : fd_.get();
+  }
+
+  bool is_fixed_file() const noexcept {
+    return fixedFile_.valid();
+  }
+
+  fsync_sender make_fsync_sender(std::uint32_t fsyncFlags) noexcept {
+    return fsync_sender{context_, sqe_fd(), is_fixed_file(), fsyncFlags};
+  }
+
+  fallocate_sender
+  make_fallocate_sender(int mode, offset_t offset, offset_t length) noexcept {
+    return fallocate_sender{
+        context_, sqe_fd(), is_fixed_file(), mode, offset, length};
+  }
+
+  template <typename BufferSequence>
+  readv_sender<std::remove_cvref_t<BufferSequence>> make_readv_sender(
+      offset_t offset,
+      BufferSequence&& buffers,
+      std::optional<time_point> deadline = std::nullopt) {
+    return readv_sender<std::remove_cvref_t<BufferSequence>>{
+        context_,
+        sqe_fd(),
+        offset,
+        (BufferSequence &&) buffers,
+        is_fixed_file(),
+        deadline};
+  }
+
+  template <typename BufferSequence>
+  writev_sender<std::remove_cvref_t<BufferSequence>> make_writev_sender(
+      offset_t offset,
+      BufferSequence&& buffers,
+      std::optional<time_point> deadline = std::nullopt) {
+    return writev_sender<std::remove_cvref_t<BufferSequence>>{
+        context_,
+        sqe_fd(),
+        offset,
+        (BufferSequence &&) buffers,
+        is_fixed_file(),
+        deadline};
+  }
+
+ private:
+  friend close_sender;
+
+  // Closes the file without blocking the I/O thread. The file object must
+  // be kept alive until the operation completes but no longer refers to
+  // an open file once the operation has started.
+  friend close_sender tag_invoke(
+      tag_t<async_close>,
+      async_file_base& file) noexcept {
+    return close_sender{file.context_, file};
+  }
+
+  friend statx_sender tag_invoke(
+      tag_t<async_statx>,
+      async_file_base& file) noexcept {
+    // IORING_OP_STATX does not support registered files.
+    return statx_sender{file.context_, file.fd_.get()};
+  }
+
+ protected:
+  io_uring_context& context_;
+  safe_file_descriptor fd_;
+  // Declared after fd_ so that the slot is released before the fd is closed.
+  fixed_file_slot fixedFile_;
+};
+
+inline int io_uring_context::close_sender::release_file(
+    async_file_base& file) noexcept {
+  // Take ownership of the file descriptor so that the file object no
+  // longer closes it when destroyed. Any registered slot holds its own
+  // reference to the file so release that first.
+  file.fixedFile_ = fixed_file_slot{};
+  return file.fd_.release();
+}
+
+class io_uring_context::async_read_only_file : public async_file_base {
+ public:
+  explicit async_read_only_file(io_uring_context& context, int fd) noexcept
+      : async_file_base(context, fd) {}
+
+  read_sender async_read_some(
+      uint64_t offset,
+      span<std::byte> buffer) noexcept {
+    return read_sender{context_, sqe_fd(), offset, buffer, is_fixed_file()};
+  }
+
+ private:
+  friend scheduler;
+
+  friend read_sender tag_invoke(
+      tag_t<async_read_some_at>,
+      async_read_only_file& file,
+      offset_t offset,
+      span<std::byte> buffer) noexcept {
+    return read_sender{
+        file.context_, file.sqe_fd(), offset, buffer, file.is_fixed_file()};
+  }
+
+  friend read_sender tag_invoke(
+      tag_t<async_read_some_at_until>,
+      async_read_only_file& file,
+      offset_t offset,
+      span<std::byte> buffer,
+      const time_point& deadline) noexcept {
+    return read_sender{
+        file.context_,
+        file.sqe_fd(),
+        offset,
+        buffer,
+        file.is_fixed_file(),
+        deadline};
+  }
+
+  // Reads into each buffer of a sequence of buffers with a single readv.
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<std::remove_cvref_t<BufferSequence>, std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_read_some_at>,
+      async_read_only_file& file,
+      offset_t offset,
+      BufferSequence&& buffers) {
+    return file.make_readv_sender(offset, (BufferSequence &&) buffers);
+  }
+
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<std::remove_cvref_t<BufferSequence>, std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_read_some_at_until>,
+      async_read_only_file& file,
+      offset_t offset,
+      BufferSequence&& buffers,
+      const time_point& deadline) {
+    return file.make_readv_sender(
+        offset, (BufferSequence &&) buffers, deadline);
+  }
+};
+
+class io_uring_context::async_write_only_file : public async_file_base {
+ public:
+  explicit async_write_only_file(io_uring_context& context, int fd) noexcept
+      : async_file_base(context, fd) {}
+
+ private:
+  friend scheduler;
+
+  friend write_sender tag_invoke(
+      tag_t<async_write_some_at>,
+      async_write_only_file& file,
+      offset_t offset,
+      span<const std::byte> buffer) noexcept {
+    return write_sender{
+        file.context_, file.sqe_fd(), offset, buffer, file.is_fixed_file()};
+  }
+
+  friend write_sender tag_invoke(
+      tag_t<async_write_some_at_until>,
+      async_write_only_file& file,
+      offset_t offset,
+      span<const std::byte> buffer,
+      const time_point& deadline) noexcept {
+    return write_sender{
+        file.context_,
+        file.sqe_fd(),
+        offset,
+        buffer,
+        file.is_fixed_file(),
+        deadline};
+  }
+
+  // Writes from each buffer of a sequence of buffers with a single writev.
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<
+              std::remove_cvref_t<BufferSequence>,
+              const std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_write_some_at>,
+      async_write_only_file& file,
+      offset_t offset,
+      BufferSequence&& buffers) {
+    return file.make_writev_sender(offset, (BufferSequence &&) buffers);
+  }
+
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<
+              std::remove_cvref_t<BufferSequence>,
+              const std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_write_some_at_until>,
+      async_write_only_file& file,
+      offset_t offset,
+      BufferSequence&& buffers,
+      const time_point& deadline) {
+    return file.make_writev_sender(
+        offset, (BufferSequence &&) buffers, deadline);
+  }
+
+  friend fsync_sender tag_invoke(
+      tag_t<async_fsync>,
+      async_write_only_file& file) noexcept {
+    return file.make_fsync_sender(0);
+  }
+
+  friend fsync_sender tag_invoke(
+      tag_t<async_fdatasync>,
+      async_write_only_file& file) noexcept {
+    return file.make_fsync_sender(IORING_FSYNC_DATASYNC);
+  }
+
+  friend fallocate_sender tag_invoke(
+      tag_t<async_fallocate>,
+      async_write_only_file& file,
+      int mode,
+      offset_t offset,
+      offset_t length) noexcept {
+    return file.make_fallocate_sender(mode, offset, length);
+  }
+};
+
+class io_uring_context::async_read_write_file : public async_file_base {
+ public:
+  explicit async_read_write_file(io_uring_context& context, int fd) noexcept
+      : async_file_base(context, fd) {}
+
  private:
   friend scheduler;
 
@@ -659,7 +2097,56 @@ class io_uring_context::async_read_write_file {
       async_read_write_file& file,
       offset_t offset,
       span<const std::byte> buffer) noexcept {
-    return write_sender{file.context_, file.fd_.get(), offset, buffer};
+    return write_sender{
+        file.context_, file.sqe_fd(), offset, buffer, file.is_fixed_file()};
+  }
+
+  friend write_sender tag_invoke(
+      tag_t<async_write_some_at_until>,
+      async_read_write_file& file,
+      offset_t offset,
+      span<const std::byte> buffer,
+      const time_point& deadline) noexcept {
+    return write_sender{
+        file.context_,
+        file.sqe_fd(),
+        offset,
+        buffer,
+        file.is_fixed_file(),
+        deadline};
+  }
+
+  // Writes from each buffer of a sequence of buffers with a single writev.
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<
+              std::remove_cvref_t<BufferSequence>,
+              const std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_write_some_at>,
+      async_read_write_file& file,
+      offset_t offset,
+      BufferSequence&& buffers) {
+    return file.make_writev_sender(offset, (BufferSequence &&) buffers);
+  }
+
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<
+              std::remove_cvref_t<BufferSequence>,
+              const std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_write_some_at_until>,
+      async_read_write_file& file,
+      offset_t offset,
+      BufferSequence&& buffers,
+      const time_point& deadline) {
+    return file.make_writev_sender(
+        offset, (BufferSequence &&) buffers, deadline);
   }
 
   friend read_sender tag_invoke(
@@ -667,11 +2154,74 @@ class io_uring_context::async_read_write_file {
       async_read_write_file& file,
       offset_t offset,
       span<std::byte> buffer) noexcept {
-    return read_sender{file.context_, file.fd_.get(), offset, buffer};
+    return read_sender{
+        file.context_, file.sqe_fd(), offset, buffer, file.is_fixed_file()};
   }
 
-  io_uring_context& context_;
-  safe_file_descriptor fd_;
+  friend read_sender tag_invoke(
+      tag_t<async_read_some_at_until>,
+      async_read_write_file& file,
+      offset_t offset,
+      span<std::byte> buffer,
+      const time_point& deadline) noexcept {
+    return read_sender{
+        file.context_,
+        file.sqe_fd(),
+        offset,
+        buffer,
+        file.is_fixed_file(),
+        deadline};
+  }
+
+  // Reads into each buffer of a sequence of buffers with a single readv.
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<std::remove_cvref_t<BufferSequence>, std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_read_some_at>,
+      async_read_write_file& file,
+      offset_t offset,
+      BufferSequence&& buffers) {
+    return file.make_readv_sender(offset, (BufferSequence &&) buffers);
+  }
+
+  template <
+      typename BufferSequence,
+      std::enable_if_t<
+          is_buffer_sequence_v<std::remove_cvref_t<BufferSequence>, std::byte>,
+          int> = 0>
+  friend auto tag_invoke(
+      tag_t<async_read_some_at_until>,
+      async_read_write_file& file,
+      offset_t offset,
+      BufferSequence&& buffers,
+      const time_point& deadline) {
+    return file.make_readv_sender(
+        offset, (BufferSequence &&) buffers, deadline);
+  }
+
+  friend fsync_sender tag_invoke(
+      tag_t<async_fsync>,
+      async_read_write_file& file) noexcept {
+    return file.make_fsync_sender(0);
+  }
+
+  friend fsync_sender tag_invoke(
+      tag_t<async_fdatasync>,
+      async_read_write_file& file) noexcept {
+    return file.make_fsync_sender(IORING_FSYNC_DATASYNC);
+  }
+
+  friend fallocate_sender tag_invoke(
+      tag_t<async_fallocate>,
+      async_read_write_file& file,
+      int mode,
+      offset_t offset,
+      offset_t length) noexcept {
+    return file.make_fallocate_sender(mode, offset, length);
+  }
 };
 
 class io_uring_context::schedule_at_sender {
@@ -889,6 +2439,28 @@ class io_uring_context::scheduler {
       scheduler s,
       const filesystem::path& path);
 
+  friend open_sender<async_read_only_file> tag_invoke(
+      tag_t<async_open_file_read_only>,
+      scheduler s,
+      const filesystem::path& path) {
+    return open_sender<async_read_only_file>{
+        *s.context_, path, O_RDONLY | O_CLOEXEC};
+  }
+  friend open_sender<async_read_write_file> tag_invoke(
+      tag_t<async_open_file_read_write>,
+      scheduler s,
+      const filesystem::path& path) {
+    return open_sender<async_read_write_file>{
+        *s.context_, path, O_RDWR | O_CREAT | O_CLOEXEC};
+  }
+  friend open_sender<async_write_only_file> tag_invoke(
+      tag_t<async_open_file_write_only>,
+      scheduler s,
+      const filesystem::path& path) {
+    return open_sender<async_write_only_file>{
+        *s.context_, path, O_WRONLY | O_CREAT | O_CLOEXEC};
+  }
+
   friend bool operator==(const scheduler& a, const scheduler& b) noexcept {
     return a.context_ == b.context_;
   }
@@ -898,6 +2470,44 @@ class io_uring_context::scheduler {
   io_uring_context* context_;
 };
 
+// A pool of fixed-size blocks of memory allocated from a single region that
+// is registered with an io_uring_context. Reads and writes to and from these
+// blocks use the context's registered-buffer operations.
+//
+// allocate() and deallocate() may be called from any thread.
+class io_uring_context::registered_buffer_pool {
+ public:
+  explicit registered_buffer_pool(
+      io_uring_context& context,
+      std::size_t blockSize,
+      std::size_t blockCount);
+
+  registered_buffer_pool(const registered_buffer_pool&) = delete;
+  registered_buffer_pool& operator=(const registered_buffer_pool&) = delete;
+
+  // There must not be any outstanding I/O using blocks from this pool.
+  ~registered_buffer_pool();
+
+  // Obtain an unused block from the pool.
+  // Throws std::bad_alloc if all of the blocks are in use.
+  span<std::byte> allocate();
+
+  // Return a block previously obtained from allocate() to the pool.
+  void deallocate(span<std::byte> block) noexcept;
+
+  std::size_t block_size() const noexcept {
+    return blockSize_;
+  }
+
+ private:
+  io_uring_context& context_;
+  std::size_t blockSize_;
+  mmap_region region_;
+  std::uint32_t bufferIndex_;
+  std::mutex mutex_;
+  std::vector<std::byte*> freeBlocks_;
+};
+
 inline io_uring_context::scheduler io_uring_context::get_scheduler() noexcept {
   return scheduler{*this};
 }
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/file_concepts.hpp>
+#include <unifex/filesystem.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/linux/io_uring_context.hpp>
+#include <unifex/tag_invoke.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace unifex {
+namespace linux {
+
+// A set of io_uring_contexts, each with its own ring and its own thread
+// calling run(), used to spread I/O across multiple cores.
+//
+// Work scheduled from one of the pool's threads stays on that thread's
+// ring. Work scheduled from any other thread is placed on a ring chosen
+// by the pool's placement policy.
+class io_uring_pool {
+ public:
+  class scheduler;
+
+  enum class placement_policy {
+    // Place work on the ring with the fewest I/O operations in flight.
+    least_pending,
+
+    // Place files on a ring chosen by hashing their file descriptor so that
+    // all I/O on a given file is serviced by the same ring. Work that is not
+    // associated with a file is placed as for least_pending.
+    hash_by_fd,
+  };
+
+  struct options {
+    // Number of rings, each driven by its own thread.
+    // If zero then one ring is created per available CPU.
+    std::uint32_t ringCount = 0;
+
+    // If true then the thread driving ring N is pinned to the N-th CPU
+    // that the process is allowed to run on (wrapping around if there are
+    // more rings than CPUs). Threads are pinned before their ring is
+    // created.
+    bool pinThreads = false;
+
+    placement_policy placement = placement_policy::least_pending;
+
+    // Options used to create each ring.
+    io_uring_context::options contextOptions;
+  };
+
+  io_uring_pool();
+
+  explicit io_uring_pool(const options& opts);
+
+  // Stops and joins all of the pool's threads.
+  // There must not be any outstanding work on the pool.
+  ~io_uring_pool();
+
+  io_uring_pool(const io_uring_pool&) = delete;
+  io_uring_pool& operator=(const io_uring_pool&) = delete;
+
+  scheduler get_scheduler() noexcept;
+
+  std::size_t size() const noexcept {
+    return rings_.size();
+  }
+
+  io_uring_context& context(std::size_t index) noexcept {
+    return rings_[index]->context();
+  }
+
+  // The context whose thread is the calling thread, or nullptr if the
+  // calling thread is not one of this pool's threads.
+  io_uring_context* current_context() const noexcept;
+
+  // Choose the context to place new work on.
+  io_uring_context& select_context() noexcept;
+
+  // Choose the context to place I/O on the given file descriptor on.
+  io_uring_context& select_context(int fd) noexcept;
+
+ private:
+  struct ring {
+    io_uring_context& context() noexcept {
+      return *context_;
+    }
+
+    // Created by thread_ before it calls run().
+    std::optional<io_uring_context> context_;
+    std::thread thread_;
+  };
+
+  io_uring_context& least_pending_context() noexcept;
+
+  void stop() noexcept;
+
+  placement_policy placement_;
+  inplace_stop_source stopSource_;
+  std::vector<std::unique_ptr<ring>> rings_;
+
+  // Where to start looking for the least-loaded ring. Advanced on every
+  // placement so that rings with equal load are used in turn.
+  std::atomic<std::uint32_t> nextRing_{0};
+};
+
+class io_uring_pool::scheduler {
+ public:
+  scheduler(const scheduler&) noexcept = default;
+  scheduler& operator=(const scheduler&) = default;
+  ~scheduler() = default;
+
+  io_uring_context::schedule_sender schedule() const noexcept {
+    return pool_->select_context().get_scheduler().schedule();
+  }
+
+  io_uring_context::time_point now() const noexcept {
+    return monotonic_clock::now();
+  }
+
+  io_uring_context::schedule_at_sender schedule_at(
+      const io_uring_context::time_point& dueTime) const noexcept {
+    return pool_->select_context().get_scheduler().schedule_at(dueTime);
+  }
+
+ private:
+  friend io_uring_pool;
+
+  // Files are opened on the calling thread and then associated with the
+  // context selected for their file descriptor.
+  friend io_uring_context::async_read_only_file tag_invoke(
+      tag_t<open_file_read_only>,
+      scheduler s,
+      const filesystem::path& path);
+  friend io_uring_context::async_read_write_file tag_invoke(
+      tag_t<open_file_read_write>,
+      scheduler s,
+      const filesystem::path& path);
+  friend io_uring_context::async_write_only_file tag_invoke(
+      tag_t<open_file_write_only>,
+      scheduler s,
+      const filesystem::path& path);
+
+  // Asynchronous opens don't have a file descriptor until the open has
+  // completed so they are always placed as though for new work.
+  friend auto tag_invoke(
+      tag_t<async_open_file_read_only>,
+      scheduler s,
+      const filesystem::path& path) {
+    return async_open_file_read_only(
+        s.pool_->select_context().get_scheduler(), path);
+  }
+  friend auto tag_invoke(
+      tag_t<async_open_file_read_write>,
+      scheduler s,
+      const filesystem::path& path) {
+    return async_open_file_read_write(
+        s.pool_->select_context().get_scheduler(), path);
+  }
+  friend auto tag_invoke(
+      tag_t<async_open_file_write_only>,
+      scheduler s,
+      const filesystem::path& path) {
+    return async_open_file_write_only(
+        s.pool_->select_context().get_scheduler(), path);
+  }
+
+  friend bool operator==(const scheduler& a, const scheduler& b) noexcept {
+    return a.pool_ == b.pool_;
+  }
+
+  explicit scheduler(io_uring_pool& pool) noexcept : pool_(&pool) {}
+
+  io_uring_pool* pool_;
+};
+
+inline io_uring_pool::scheduler io_uring_pool::get_scheduler() noexcept {
+  return scheduler{*this};
+}
+
+} // namespace linux
+} // namespace unifex
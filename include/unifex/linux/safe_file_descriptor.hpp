@@ -48,6 +48,11 @@ class safe_file_descriptor {
     return fd_;
   }
 
+  // Give up ownership of the file descriptor without closing it.
+  int release() noexcept {
+    return std::exchange(fd_, -1);
+  }
+
   void close() noexcept;
 
  private:
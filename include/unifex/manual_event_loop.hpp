@@ -16,12 +16,17 @@
 #pragma once
 
 #include <unifex/blocking.hpp>
+#include <unifex/detail/atomic_intrusive_queue.hpp>
+#include <unifex/detail/loop_sync_wait.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
 #include <unifex/stop_token_concepts.hpp>
+#include <unifex/unstoppable_token.hpp>
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <optional>
 #include <type_traits>
 
 namespace unifex {
@@ -119,16 +124,61 @@ class manual_event_loop {
 
   void run();
 
+  // Makes run() return once it has run all of the tasks scheduled so far.
+  // Can be called from any thread, but the loop must not be destroyed until
+  // stop() has returned.
   void stop();
 
+  // Runs the loop on the calling thread until 'sender' has completed and
+  // returns its result, as for unifex::sync_wait().
+  //
+  // Must not be called while run() is running on another thread.
+  template <
+      typename Sender,
+      typename StopToken = unstoppable_token,
+      typename Result = single_value_result_t<std::remove_cvref_t<Sender>>>
+  std::optional<Result> sync_wait(Sender&& sender, StopToken&& st = {}) {
+    detail::loop_sync_wait_promise<Result> promise;
+
+    auto op = cpo::connect(
+        (Sender &&) sender,
+        detail::loop_sync_wait_receiver<Result, StopToken&&, wake_up_fn>{
+            promise, (StopToken &&) st, wake_up_fn{this}});
+    cpo::start(op);
+
+    run_until(promise.completed());
+
+    return std::move(promise).get();
+  }
+
  private:
-  void enqueue(task_base* task);
+  struct wake_up_fn {
+    manual_event_loop* loop_;
+
+    void operator()() noexcept {
+      loop_->wake_up();
+    }
+  };
+
+  // Runs tasks until 'stop' is set and there are no tasks left to run.
+  void run_until(const std::atomic<bool>& stop);
+
+  void enqueue(task_base* task) noexcept;
+
+  void wake_up() noexcept;
+
+  // Tasks scheduled onto the loop from any thread. run() marks the queue
+  // inactive before it goes to sleep and the producer that sees this is
+  // responsible for waking it up.
+  atomic_intrusive_queue<task_base, &task_base::next_> queue_;
+
+  // Set when run() is asleep, or about to go to sleep, and needs to wake up.
+  std::atomic<bool> wakeUp_{false};
 
-  std::mutex mutex_;
-  std::condition_variable cv_;
-  task_base* head_ = nullptr;
-  task_base* tail_ = nullptr;
-  bool stop_ = false;
+  // The number of calls to wake_up() that have set wakeUp_ but may not have
+  // finished notifying it yet. run() doesn't return until this is zero.
+  std::atomic<std::uint32_t> notifying_{0};
+  std::atomic<bool> stop_{false};
 };
 
 } // namespace unifex
@@ -18,8 +18,9 @@
 #include <unifex/sender_concepts.hpp>
 #include <unifex/tag_invoke.hpp>
 
-#include <type_traits>
+#include <cstddef>
 #include <exception>
+#include <type_traits>
 
 namespace unifex {
 namespace cpo {
@@ -133,5 +134,28 @@ inline constexpr struct now_cpo {
   }
 } now;
 
+// The number of pieces of work that a scheduler can usefully run at the same
+// time. This is 1 unless the scheduler says otherwise.
+inline constexpr struct available_parallelism_cpo {
+  template <typename Scheduler>
+  friend constexpr auto
+  tag_invoke(available_parallelism_cpo, const Scheduler& s) noexcept(
+      noexcept(s.available_parallelism()))
+      -> decltype(s.available_parallelism()) {
+    return s.available_parallelism();
+  }
+
+  template <typename Scheduler>
+  constexpr std::size_t operator()(const Scheduler& s) const noexcept {
+    if constexpr (is_tag_invocable_v<
+                      available_parallelism_cpo,
+                      const Scheduler&>) {
+      return static_cast<std::size_t>(tag_invoke(*this, s));
+    } else {
+      return 1;
+    }
+  }
+} available_parallelism;
+
 } // namespace cpo
 } // namespace unifex
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace unifex {
+
+namespace detail {
+
+// Allocate at least 'size' bytes, aligned to alignof(std::max_align_t).
+void* slab_allocate(std::size_t size);
+
+// Free a block from slab_allocate(), on any thread. 'size' must be the size
+// it was allocated with.
+void slab_deallocate(void* p, std::size_t size) noexcept;
+
+} // namespace detail
+
+// An allocator for small, short-lived objects such as the operation states
+// that submit() allocates, eg. with_allocator(sender, slab_allocator<char>{}).
+//
+// Allocations of up to 4KiB are rounded up to a power-of-two size class and
+// carved out of larger slabs. Each thread caches the blocks it frees, per
+// size class, and reuses them for its next allocations, so the common case of
+// an operation being freed on the thread that completes it and another being
+// allocated there doesn't take a lock. Once a thread has cached more blocks
+// than it's likely to need, or when it exits, a batch of them is returned to
+// a shared pool for other threads to take. Slabs are never returned to the
+// system. Larger allocations use ::operator new.
+//
+// All slab_allocators are equal: memory allocated by any of them can be
+// freed by any other, on any thread.
+template <typename T>
+class slab_allocator {
+  static_assert(
+      alignof(T) <= alignof(std::max_align_t),
+      "slab_allocator doesn't support over-aligned types");
+
+ public:
+  using value_type = T;
+
+  slab_allocator() noexcept = default;
+
+  template <typename U>
+  slab_allocator(const slab_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length{};
+    }
+    return static_cast<T*>(detail::slab_allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    detail::slab_deallocate(p, n * sizeof(T));
+  }
+
+  friend bool operator==(slab_allocator, slab_allocator) noexcept {
+    return true;
+  }
+
+  friend bool operator!=(slab_allocator, slab_allocator) noexcept {
+    return false;
+  }
+};
+
+} // namespace unifex
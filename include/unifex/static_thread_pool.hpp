@@ -0,0 +1,199 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/blocking.hpp>
+#include <unifex/detail/intrusive_queue.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace unifex {
+
+// A fixed-size pool of worker threads that share work by stealing.
+//
+// Each worker has its own Chase-Lev deque. Work scheduled from one of the
+// pool's own threads goes into that worker's 'LIFO slot' so the next thing
+// it runs is the continuation it just scheduled, while it's still hot in
+// the cache. Whatever was in the slot before moves to the worker's deque,
+// where idle workers can steal it. Work scheduled from other threads goes
+// into a shared queue that all workers take from.
+//
+// Workers with nothing to run or steal park until there is more work.
+//
+// Only the worker that owns a LIFO slot runs the work in it, so work running
+// on the pool shouldn't block waiting for work that it has just scheduled.
+class static_thread_pool {
+  struct task_base {
+    task_base* next_ = nullptr;
+    virtual void execute() noexcept = 0;
+  };
+
+  class worker;
+
+ public:
+  class scheduler {
+    class schedule_sender {
+     public:
+      template <
+          template <typename...> class Variant,
+          template <typename...> class Tuple>
+      using value_types = Variant<Tuple<>>;
+
+      template <template <typename...> class Variant>
+      using error_types = Variant<>;
+
+     private:
+      friend constexpr blocking_kind tag_invoke(
+          tag_t<cpo::blocking>,
+          const schedule_sender&) noexcept {
+        return blocking_kind::never;
+      }
+
+      template <typename Receiver>
+      class operation final : task_base {
+        using stop_token_type = stop_token_type_t<Receiver&>;
+
+       public:
+        void start() noexcept {
+          pool_->enqueue(this);
+        }
+
+       private:
+        friend schedule_sender;
+
+        template <typename Receiver2>
+        explicit operation(Receiver2&& receiver, static_thread_pool* pool)
+          : receiver_((Receiver2 &&) receiver), pool_(pool) {}
+
+        void execute() noexcept override {
+          if constexpr (is_stop_never_possible_v<stop_token_type>) {
+            cpo::set_value(std::move(receiver_));
+          } else {
+            if (get_stop_token(receiver_).stop_requested()) {
+              cpo::set_done(std::move(receiver_));
+            } else {
+              cpo::set_value(std::move(receiver_));
+            }
+          }
+        }
+
+        UNIFEX_NO_UNIQUE_ADDRESS Receiver receiver_;
+        static_thread_pool* const pool_;
+      };
+
+     public:
+      template <typename Receiver>
+      operation<std::remove_cvref_t<Receiver>> connect(Receiver&& receiver) && {
+        return operation<std::remove_cvref_t<Receiver>>{(Receiver &&) receiver,
+                                                        pool_};
+      }
+
+     private:
+      friend scheduler;
+
+      explicit schedule_sender(static_thread_pool* pool) noexcept
+        : pool_(pool) {}
+
+      static_thread_pool* const pool_;
+    };
+
+    friend static_thread_pool;
+
+    explicit scheduler(static_thread_pool* pool) noexcept : pool_(pool) {}
+
+   public:
+    schedule_sender schedule() const noexcept {
+      return schedule_sender{pool_};
+    }
+
+    std::uint32_t available_parallelism() const noexcept {
+      return pool_->available_parallelism();
+    }
+
+    friend bool operator==(scheduler a, scheduler b) noexcept {
+      return a.pool_ == b.pool_;
+    }
+
+    friend bool operator!=(scheduler a, scheduler b) noexcept {
+      return a.pool_ != b.pool_;
+    }
+
+   private:
+    static_thread_pool* pool_;
+  };
+
+  // Starts one worker per hardware thread.
+  static_thread_pool();
+
+  explicit static_thread_pool(std::uint32_t threadCount);
+
+  // Runs all of the work scheduled so far and then joins the workers.
+  ~static_thread_pool();
+
+  static_thread_pool(const static_thread_pool&) = delete;
+  static_thread_pool& operator=(const static_thread_pool&) = delete;
+
+  scheduler get_scheduler() noexcept {
+    return scheduler{this};
+  }
+
+  std::uint32_t available_parallelism() const noexcept {
+    return threadCount_;
+  }
+
+ private:
+  void enqueue(task_base* task) noexcept;
+
+  void enqueue_remote(task_base* task) noexcept;
+
+  // Take a batch of tasks from the shared queue. Returns nullptr if it's
+  // empty.
+  task_base* take_remote(worker& w) noexcept;
+
+  // Whether there is any work that a parked worker could pick up.
+  bool has_work() const noexcept;
+
+  // Wake up a parked worker, if there are any, after making work available.
+  void notify_one_parked() noexcept;
+
+  void stop_and_join() noexcept;
+
+  const std::uint32_t threadCount_;
+  std::unique_ptr<worker[]> workers_;
+
+  // Work scheduled from threads outside the pool.
+  std::mutex remoteMutex_;
+  intrusive_queue<task_base, &task_base::next_> remoteQueue_;
+  std::atomic<std::size_t> remoteCount_{0};
+
+  // Parked workers wait for parkEpoch_ to change.
+  std::atomic<std::uint32_t> parkedCount_{0};
+  std::atomic<std::uint32_t> parkEpoch_{0};
+  std::atomic<bool> stop_{false};
+
+  std::vector<std::thread> threads_;
+};
+
+} // namespace unifex
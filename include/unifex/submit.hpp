@@ -121,6 +121,7 @@ inline constexpr struct submit_cpo {
           // state on the heap.
           auto op = cpo::connect((Sender &&) sender, (Receiver &&) receiver);
           cpo::start(op);
+          break;
         }
         default:
         {
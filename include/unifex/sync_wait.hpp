@@ -21,38 +21,98 @@
 #include <unifex/blocking.hpp>
 #include <unifex/get_stop_token.hpp>
 
-#include <condition_variable>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <exception>
-#include <mutex>
+#include <optional>
+#include <thread>
 #include <type_traits>
 #include <utility>
-#include <optional>
-#include <cassert>
 
 namespace unifex {
 
 namespace detail {
+// The result of a sync_wait() whose sender may complete on another thread.
+//
+// The state is a single atomic word that the waiting thread blocks on with
+// std::atomic::wait(), which is a futex on Linux. If the sender completes
+// before the waiting thread has blocked then neither thread makes a system
+// call.
 template <typename T>
 struct sync_wait_promise {
   sync_wait_promise() {}
 
   ~sync_wait_promise() {
-    if (state_ == state::value) {
+    const auto s = static_cast<state>(state_.load(std::memory_order_relaxed));
+    if (s == state::value) {
       value_.destruct();
-    } else if (state_ == state::error) {
+    } else if (s == state::error) {
       exception_.destruct();
     }
   }
 
-  std::mutex mutex_;
-  std::condition_variable cv_;
+  enum class state : std::uint32_t { incomplete, done, value, error };
+
+  // Call once the result has been stored.
+  void complete(state s) noexcept {
+    std::uint32_t expected = static_cast<std::uint32_t>(state::incomplete);
+    if (state_.compare_exchange_strong(
+            expected,
+            static_cast<std::uint32_t>(s),
+            std::memory_order_release,
+            std::memory_order_relaxed)) {
+      // Nobody is blocked yet. The waiting thread may destroy the promise as
+      // soon as it sees the result so don't touch it again.
+      return;
+    }
+
+    // The waiting thread is blocked. Stop it from destroying the promise
+    // until we've finished waking it up.
+    assert(expected == waiting_flag);
+    state_.store(
+        static_cast<std::uint32_t>(s) | notifying_flag,
+        std::memory_order_release);
+    state_.notify_one();
+    state_.store(static_cast<std::uint32_t>(s), std::memory_order_release);
+  }
+
+  // Blocks until complete() has been called and has finished with the
+  // promise.
+  state wait() noexcept {
+    std::uint32_t s = static_cast<std::uint32_t>(state::incomplete);
+    if (state_.compare_exchange_strong(
+            s,
+            waiting_flag,
+            std::memory_order_acquire,
+            std::memory_order_acquire)) {
+      s = waiting_flag;
+    }
+    while (s == waiting_flag) {
+      state_.wait(waiting_flag, std::memory_order_acquire);
+      s = state_.load(std::memory_order_acquire);
+    }
+    // The completing thread is only in the middle of a notify_one() here.
+    while ((s & notifying_flag) != 0) {
+      std::this_thread::yield();
+      s = state_.load(std::memory_order_acquire);
+    }
+    return static_cast<state>(s);
+  }
+
+  // Set by wait() before it blocks.
+  static constexpr std::uint32_t waiting_flag = 4;
+
+  // Set by complete() while it wakes up the waiting thread.
+  static constexpr std::uint32_t notifying_flag = 8;
+
   union {
     manual_lifetime<T> value_;
     manual_lifetime<std::exception_ptr> exception_;
   };
 
-  enum class state { incomplete, done, value, error };
-  state state_ = state::incomplete;
+  std::atomic<std::uint32_t> state_{
+      static_cast<std::uint32_t>(state::incomplete)};
 };
 
 template <typename T, typename StopToken>
@@ -62,22 +122,18 @@ struct sync_wait_receiver {
 
   template <typename... Values>
       void value(Values&&... values) && noexcept {
-    std::lock_guard lock{promise_.mutex_};
     try {
       promise_.value_.construct((Values &&) values...);
-      promise_.state_ = sync_wait_promise<T>::state::value;
+      promise_.complete(sync_wait_promise<T>::state::value);
     } catch (...) {
       promise_.exception_.construct(std::current_exception());
-      promise_.state_ = sync_wait_promise<T>::state::error;
+      promise_.complete(sync_wait_promise<T>::state::error);
     }
-    promise_.cv_.notify_one();
   }
 
   void error(std::exception_ptr err) && noexcept {
-    std::lock_guard lock{promise_.mutex_};
     promise_.exception_.construct(std::move(err));
-    promise_.state_ = sync_wait_promise<T>::state::error;
-    promise_.cv_.notify_one();
+    promise_.complete(sync_wait_promise<T>::state::error);
   }
 
   template <typename Error>
@@ -86,9 +142,7 @@ struct sync_wait_receiver {
   }
 
   void done() && noexcept {
-    std::lock_guard lock{promise_.mutex_};
-    promise_.state_ = sync_wait_promise<T>::state::done;
-    promise_.cv_.notify_one();
+    promise_.complete(sync_wait_promise<T>::state::done);
   }
 
   friend const StopToken& tag_invoke(
@@ -165,6 +219,8 @@ auto sync_wait(Sender&& sender, StopToken&& stopToken = {})
   auto blockingResult = cpo::blocking(sender);
   if (blockingResult == blocking_kind::always ||
       blockingResult == blocking_kind::always_inline) {
+    // The sender completes before start() returns so there's nothing to
+    // wait for.
     using promise_t = detail::thread_unsafe_sync_wait_promise<Result>;
     promise_t promise;
 
@@ -199,11 +255,7 @@ auto sync_wait(Sender&& sender, StopToken&& stopToken = {})
 
     cpo::start(operation);
 
-    std::unique_lock lock{promise.mutex_};
-    promise.cv_.wait(
-        lock, [&] { return promise.state_ != promise_t::state::incomplete; });
-
-    switch (promise.state_) {
+    switch (promise.wait()) {
       case promise_t::state::done:
         return std::nullopt;
       case promise_t::state::value:
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/unstoppable_token.hpp>
+
+namespace unifex {
+
+// Like sync_wait() but runs 'context's event loop on the calling thread until
+// 'sender' has completed, rather than blocking while another thread runs it.
+//
+// Supported by manual_event_loop, thread_unsafe_event_loop and
+// io_uring_context. Nothing else may be running the loop at the same time.
+template <
+    typename Context,
+    typename Sender,
+    typename StopToken = unstoppable_token>
+decltype(auto)
+sync_wait_on(Context& context, Sender&& sender, StopToken&& st = {}) {
+  return context.sync_wait((Sender &&) sender, (StopToken &&) st);
+}
+
+} // namespace unifex
@@ -18,20 +18,153 @@
 #include <unifex/async_trace.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/config.hpp>
+#include <unifex/slab_allocator.hpp>
 
 #if UNIFEX_NO_COROUTINES
 # error "C++20 coroutine support is required to use this header"
 #endif
 
+#include <cstddef>
 #include <exception>
 #include <experimental/coroutine>
+#include <memory>
+#include <new>
 #include <optional>
+#include <utility>
 
 namespace unifex {
 
+namespace detail {
+
+// Allocates task coroutine frames.
+//
+// Each allocation has a trailer after the frame holding the function that
+// frees it, followed by the allocator if there is one, so that the
+// promise's operator delete can free any frame given only its size.
+class task_frame {
+  using deallocate_fn = void(void*, std::size_t) noexcept;
+
+  static constexpr std::size_t align_up(
+      std::size_t size,
+      std::size_t alignment) noexcept {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  static constexpr std::size_t trailer_offset(std::size_t size) noexcept {
+    return align_up(size, alignof(deallocate_fn*));
+  }
+
+  static constexpr std::size_t pooled_size(std::size_t size) noexcept {
+    return trailer_offset(size) + sizeof(deallocate_fn*);
+  }
+
+  template <typename Allocator>
+  static constexpr std::size_t allocator_offset(std::size_t size) noexcept {
+    return align_up(pooled_size(size), alignof(Allocator));
+  }
+
+  template <typename Allocator>
+  static constexpr std::size_t allocation_count(std::size_t size) noexcept {
+    return align_up(
+               allocator_offset<Allocator>(size) + sizeof(Allocator),
+               sizeof(std::max_align_t)) /
+        sizeof(std::max_align_t);
+  }
+
+  static deallocate_fn*& trailer(void* frame, std::size_t size) noexcept {
+    return *static_cast<deallocate_fn**>(static_cast<void*>(
+        static_cast<std::byte*>(frame) + trailer_offset(size)));
+  }
+
+  template <typename Allocator>
+  static Allocator* allocator(void* frame, std::size_t size) noexcept {
+    return static_cast<Allocator*>(static_cast<void*>(
+        static_cast<std::byte*>(frame) + allocator_offset<Allocator>(size)));
+  }
+
+  static void deallocate_pooled(void* frame, std::size_t size) noexcept {
+    detail::slab_deallocate(frame, pooled_size(size));
+  }
+
+  template <typename Allocator>
+  static void deallocate_with(void* frame, std::size_t size) noexcept {
+    using traits = std::allocator_traits<Allocator>;
+    Allocator* allocatorPtr = allocator<Allocator>(frame, size);
+    Allocator alloc{std::move(*allocatorPtr)};
+    allocatorPtr->~Allocator();
+    traits::deallocate(
+        alloc,
+        static_cast<std::max_align_t*>(frame),
+        allocation_count<Allocator>(size));
+  }
+
+ public:
+  // Allocate a frame from the thread's cache of recently freed frames of
+  // the same size class, see slab_allocator.
+  static void* allocate(std::size_t size) {
+    void* frame = detail::slab_allocate(pooled_size(size));
+    trailer(frame, size) = &deallocate_pooled;
+    return frame;
+  }
+
+  // Allocate a frame using 'alloc'.
+  template <typename Allocator>
+  static void* allocate(std::size_t size, const Allocator& alloc) {
+    using allocator_type = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<std::max_align_t>;
+    using traits = std::allocator_traits<allocator_type>;
+    static_assert(alignof(allocator_type) <= alignof(std::max_align_t));
+
+    allocator_type typedAllocator{alloc};
+    void* frame = traits::allocate(
+        typedAllocator, allocation_count<allocator_type>(size));
+    ::new (static_cast<void*>(allocator<allocator_type>(frame, size)))
+        allocator_type(std::move(typedAllocator));
+    trailer(frame, size) = &deallocate_with<allocator_type>;
+    return frame;
+  }
+
+  static void deallocate(void* frame, std::size_t size) noexcept {
+    trailer(frame, size)(frame, size);
+  }
+};
+
+} // namespace detail
+
 template <typename T>
 struct task {
+  // Coroutine frames come from a per-thread pool of recycled frames unless
+  // the coroutine's parameters start with (std::allocator_arg_t, Allocator),
+  // after 'this' for member functions, in which case they're allocated
+  // using that allocator.
   struct promise_type {
+    static void* operator new(std::size_t size) {
+      return detail::task_frame::allocate(size);
+    }
+
+    template <typename Allocator, typename... Args>
+    static void* operator new(
+        std::size_t size,
+        std::allocator_arg_t,
+        const Allocator& alloc,
+        const Args&...) {
+      return detail::task_frame::allocate(size, alloc);
+    }
+
+    template <typename This, typename Allocator, typename... Args>
+    static void* operator new(
+        std::size_t size,
+        const This&,
+        std::allocator_arg_t,
+        const Allocator& alloc,
+        const Args&...) {
+      return detail::task_frame::allocate(size, alloc);
+    }
+
+    static void operator delete(void* frame, std::size_t size) noexcept {
+      detail::task_frame::deallocate(frame, size);
+    }
+
     task get_return_object() noexcept {
       return task{
           std::experimental::coroutine_handle<promise_type>::from_promise(
@@ -44,7 +177,7 @@ struct task {
 
     auto final_suspend() noexcept {
       struct awaiter {
-        bool await_ready() {
+        bool await_ready() noexcept {
           return false;
         }
         auto await_suspend(
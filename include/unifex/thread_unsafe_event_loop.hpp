@@ -16,11 +16,14 @@
 #pragma once
 
 #include <unifex/config.hpp>
+#include <unifex/detail/intrusive_queue.hpp>
+#include <unifex/detail/intrusive_timing_wheel.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
 #include <unifex/stop_token_concepts.hpp>
+#include <unifex/timer_backend.hpp>
 
 #include <cassert>
 #include <chrono>
@@ -56,7 +59,7 @@ class thread_unsafe_event_loop {
 
     thread_unsafe_event_loop& loop_;
     operation_base* next_;
-    operation_base** prevPtr_;
+    operation_base** prevPtr_ = nullptr;
 
    protected:
     time_point_t dueTime_;
@@ -238,6 +241,15 @@ class thread_unsafe_event_loop {
     thread_unsafe_event_loop& loop_;
   };
 
+  thread_unsafe_event_loop() noexcept = default;
+
+  // Hold pending timers in the given backend. 'wheelTick' is the tick of a
+  // timer_backend::timing_wheel, and is rounded up to at least one tick of
+  // the clock.
+  explicit thread_unsafe_event_loop(
+      timer_backend backend,
+      std::chrono::nanoseconds wheelTick = default_timing_wheel_tick) noexcept;
+
   scheduler get_scheduler() noexcept {
     return scheduler{*this};
   }
@@ -350,7 +362,21 @@ class thread_unsafe_event_loop {
  private:
   void run_until_empty() noexcept;
 
+  using timer_wheel = intrusive_timing_wheel<
+      operation_base,
+      &operation_base::next_,
+      &operation_base::prevPtr_,
+      time_point_t,
+      &operation_base::dueTime_>;
+
+  // Head of a linked-list in ascending order of due-time.
   operation_base* head_ = nullptr;
+
+  // If the timing wheel backend is used then operations that are not yet
+  // due are held in 'wheel_' and those that are due are queued on 'ready_'
+  // in place of the list above.
+  std::optional<timer_wheel> wheel_;
+  intrusive_queue<operation_base, &operation_base::next_> ready_;
 };
 
 } // namespace unifex
@@ -16,15 +16,23 @@
 #pragma once
 
 #include <unifex/config.hpp>
+#include <unifex/detail/atomic_intrusive_queue.hpp>
+#include <unifex/detail/intrusive_heap.hpp>
+#include <unifex/detail/intrusive_queue.hpp>
+#include <unifex/detail/intrusive_timing_wheel.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/stop_token_concepts.hpp>
+#include <unifex/timer_backend.hpp>
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <type_traits>
 
@@ -36,16 +44,54 @@ class timed_single_thread_context {
   using time_point = typename clock_t::time_point;
 
  private:
+  struct task_base;
+
+  // A request for the timer thread to schedule or to cancel a task, sent
+  // through the lock-free remote queue.
+  struct remote_request {
+    explicit remote_request(task_base* task) noexcept : task_(task) {}
+
+    remote_request* next_ = nullptr;
+    task_base* const task_;
+  };
+
   struct task_base {
     explicit task_base(timed_single_thread_context* context) noexcept
         : context_(context) {
       assert(context_ != nullptr);
     }
 
+    // Where the task is, as seen by the timer thread.
+    enum class location : std::uint8_t {
+      submitted, // Schedule request not yet received.
+      queued, // In the timer heap or wheel.
+      ready, // On the ready queue.
+      detached // Taken off the queues to be executed.
+    };
+
+    static constexpr std::uint32_t elapsed_flag = 1;
+    static constexpr std::uint32_t cancel_pending_flag = 2;
+
     timed_single_thread_context* const context_;
+    time_point dueTime_;
+
+    // Links for the timer thread's heap, wheel and ready queue.
     task_base* next_ = nullptr;
+    task_base* prev_ = nullptr;
+    task_base* child_ = nullptr;
     task_base** prevNextPtr_ = nullptr;
-    time_point dueTime_;
+
+    remote_request scheduleRequest_{this};
+    remote_request cancelRequest_{this};
+
+    // Combination of elapsed_flag and cancel_pending_flag. Whichever of the
+    // timer thread and the cancelling thread sets its flag second leaves the
+    // task to the other.
+    std::atomic<std::uint32_t> state_ = 0;
+
+    // Only accessed by the timer thread.
+    location location_ = location::submitted;
+    bool cancelled_ = false;
 
     virtual void execute() noexcept = 0;
   };
@@ -160,6 +206,8 @@ class timed_single_thread_context {
         }
 
        private:
+        friend schedule_at_sender;
+
         template <typename Receiver2>
         explicit operation(
             timed_single_thread_context* scheduler,
@@ -173,8 +221,7 @@ class timed_single_thread_context {
           cancelCallback_.destruct();
           if constexpr (is_stop_never_possible_v<
                             stop_token_type_t<Receiver&>>) {
-            cpo::set_value(
-                static_cast<Receiver&&>(receiver_), scheduler{this->context_});
+            cpo::set_value(static_cast<Receiver&&>(receiver_));
           } else {
             if (get_stop_token(receiver_).stop_requested()) {
               cpo::set_done(static_cast<Receiver&&>(receiver_));
@@ -244,6 +291,13 @@ class timed_single_thread_context {
 
   timed_single_thread_context();
 
+  // Hold pending timers in the given backend. 'wheelTick' is the tick of a
+  // timer_backend::timing_wheel, and is rounded up to at least one tick of
+  // the clock.
+  explicit timed_single_thread_context(
+      timer_backend backend,
+      std::chrono::nanoseconds wheelTick = default_timing_wheel_tick);
+
   ~timed_single_thread_context();
 
   scheduler get_scheduler() noexcept {
@@ -251,16 +305,53 @@ class timed_single_thread_context {
   }
 
  private:
+  using timer_heap = intrusive_heap<
+      task_base,
+      &task_base::child_,
+      &task_base::next_,
+      &task_base::prev_,
+      time_point,
+      &task_base::dueTime_>;
+
+  using timer_wheel = intrusive_timing_wheel<
+      task_base,
+      &task_base::next_,
+      &task_base::prevNextPtr_,
+      time_point,
+      &task_base::dueTime_>;
+
+  using request_queue =
+      atomic_intrusive_queue<remote_request, &remote_request::next_>;
+
   void enqueue(task_base* task) noexcept;
+  void send_request(remote_request* request) noexcept;
   void run();
 
+  // Timer thread only.
+  void process_requests(intrusive_queue<remote_request, &remote_request::next_>
+                            requests) noexcept;
+  void run_elapsed_tasks() noexcept;
+  void run_elapsed_task(task_base* task) noexcept;
+  std::optional<time_point> next_due_time() const noexcept;
+
+  // Schedule and cancel requests from any thread. The timer thread marks
+  // the queue inactive before it sleeps so that the next request knows to
+  // wake it up.
+  request_queue remoteQueue_;
+
+  // Only used to put the timer thread to sleep and to wake it up.
   std::mutex mutex_;
   std::condition_variable cv_;
-
-  // Head of a linked-list in ascending order of due-time.
-  task_base* head_ = nullptr;
+  bool wakeRequested_ = false;
   bool stop_ = false;
 
+  // Tasks that are not yet due, only accessed by the timer thread. If the
+  // timing wheel backend is used then 'wheel_' holds them in place of
+  // 'timers_' and tasks that are already due are queued on 'ready_'.
+  timer_heap timers_;
+  std::optional<timer_wheel> wheel_;
+  intrusive_queue<task_base, &task_base::next_> ready_;
+
   std::thread thread_;
 };
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+
+namespace unifex {
+
+// Selects how an execution context stores its pending timers.
+enum class timer_backend {
+  // Timers are kept ordered by due time and elapse as soon as the context
+  // notices that their due time has passed.
+  priority_queue,
+
+  // Timers are kept in a hierarchical hashed timing wheel. Adding and
+  // cancelling a timer are O(1) regardless of how many are pending, but due
+  // times are rounded up to a whole tick so timers can elapse up to one tick
+  // late. Suited to large numbers of coarse timeouts that are usually
+  // cancelled before they elapse.
+  timing_wheel
+};
+
+// The default tick of a timer_backend::timing_wheel.
+inline constexpr std::chrono::milliseconds default_timing_wheel_tick{1};
+
+} // namespace unifex
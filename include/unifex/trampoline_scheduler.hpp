@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <unifex/bulk.hpp>
 #include <unifex/config.hpp>
 #include <unifex/get_stop_token.hpp>
 #include <unifex/receiver_concepts.hpp>
@@ -123,6 +124,17 @@ public:
   schedule_sender schedule() const noexcept {
     return schedule_sender{maxRecursionDepth_};
   }
+
+  // There is no parallelism to be had so run the whole index space inline.
+  template <typename Sender, typename Shape, typename Func>
+  friend auto tag_invoke(
+      tag_t<cpo::bulk>,
+      Sender&& pred,
+      const trampoline_scheduler&,
+      Shape shape,
+      Func&& func) {
+    return cpo::bulk((Sender &&) pred, shape, (Func &&) func);
+  }
 };
 
 } // namespace unifex
@@ -24,12 +24,27 @@
 #include <unifex/manual_lifetime.hpp>
 #include <unifex/get_stop_token.hpp>
 
-#include <unifex/get_stop_token.hpp>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace unifex {
 
-template <typename... Values>
-struct type_erased_stream {
+// Streams that take up no more than this many bytes, once type-erased, are
+// stored inline in a type_erased_stream rather than allocated.
+inline constexpr std::size_t type_erased_stream_default_inline_size = 128;
+
+// A type-erased stream of value packs of type (Values...,).
+//
+// The concrete stream, along with storage for its next() and cleanup()
+// operations, is stored inline if it fits in 'InlineSize' bytes and is
+// nothrow move-constructible. Otherwise it is allocated using the allocator
+// the type_erased_stream is constructed with, or std::allocator if none.
+template <std::size_t InlineSize, typename... Values>
+struct basic_type_erased_stream {
   struct next_receiver_base {
     virtual void value(Values&&... values) noexcept = 0;
     virtual void done() noexcept = 0;
@@ -43,7 +58,7 @@ struct type_erased_stream {
         tag_t<visit_continuations>,
         const next_receiver_base& receiver,
         Func&& func) {
-      visit_continuations(get_continuation_info(), (Func &&) func);
+      visit_continuations(receiver.get_continuation_info(), (Func &&) func);
     }
 
     virtual continuation_info get_continuation_info() const = 0;
@@ -57,9 +72,9 @@ struct type_erased_stream {
     template <typename Func>
     friend void tag_invoke(
         tag_t<visit_continuations>,
-        const next_receiver_base& receiver,
+        const cleanup_receiver_base& receiver,
         Func&& func) {
-      visit_continuations(get_continuation_info(), (Func &&) func);
+      visit_continuations(receiver.get_continuation_info(), (Func &&) func);
     }
 
     virtual continuation_info get_continuation_info() const noexcept = 0;
@@ -71,6 +86,14 @@ struct type_erased_stream {
         next_receiver_base& receiver,
         inplace_stop_token stopToken) noexcept = 0;
     virtual void start_cleanup(cleanup_receiver_base& receiver) noexcept = 0;
+
+    // Destroy the stream and free its storage.
+    virtual void destroy() noexcept = 0;
+
+    // Move an inline stream into 'buffer' and return it there. A stream
+    // that isn't inline just returns itself. Only called while no next() or
+    // cleanup() operation is running.
+    virtual stream_base* move_to(void* buffer) noexcept = 0;
   };
 
   template <typename Receiver>
@@ -120,7 +143,7 @@ struct type_erased_stream {
   };
 
   template <typename Stream>
-  struct concrete_stream final : stream_base {
+  struct concrete_stream : stream_base {
     UNIFEX_NO_UNIQUE_ADDRESS Stream stream_;
 
     // TODO: static_assert that all values() overloads produced
@@ -208,6 +231,11 @@ struct type_erased_stream {
     template <typename Stream2>
     explicit concrete_stream(Stream2&& stream) : stream_((Stream2 &&) stream) {}
 
+    // Only moves the stream itself as there are no operations running.
+    concrete_stream(concrete_stream&& other) noexcept(
+        std::is_nothrow_move_constructible_v<Stream>)
+      : stream_(std::move(other.stream_)) {}
+
     ~concrete_stream() {}
 
     union {
@@ -248,6 +276,50 @@ struct type_erased_stream {
     }
   };
 
+  template <typename Stream>
+  struct inline_stream final : concrete_stream<Stream> {
+    using concrete_stream<Stream>::concrete_stream;
+
+    void destroy() noexcept override {
+      this->~inline_stream();
+    }
+
+    stream_base* move_to(void* buffer) noexcept override {
+      auto* moved = ::new (buffer) inline_stream(std::move(*this));
+      this->~inline_stream();
+      return moved;
+    }
+  };
+
+  template <typename Stream, typename Allocator>
+  struct allocated_stream final : concrete_stream<Stream> {
+    using allocator_type = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<allocated_stream>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    template <typename Stream2>
+    explicit allocated_stream(Stream2&& stream, const allocator_type& alloc)
+      : concrete_stream<Stream>((Stream2 &&) stream), alloc_(alloc) {}
+
+    void destroy() noexcept override {
+      allocator_type alloc = std::move(alloc_);
+      this->~allocated_stream();
+      allocator_traits::deallocate(alloc, this, 1);
+    }
+
+    stream_base* move_to(void*) noexcept override {
+      return this;
+    }
+
+    UNIFEX_NO_UNIQUE_ADDRESS allocator_type alloc_;
+  };
+
+  template <typename Stream>
+  static constexpr bool fits_inline =
+      sizeof(inline_stream<Stream>) <= InlineSize &&
+      alignof(inline_stream<Stream>) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<Stream>;
+
   struct next_sender {
     stream_base& stream_;
 
@@ -281,7 +353,7 @@ struct type_erased_stream {
             stopSource_(),
             receiver_((Receiver2 &&) receiver),
             stopCallback_(
-              get_stop_callback(receiver_.receiver_),
+              get_stop_token(receiver_.receiver_),
               cancel_callback{stopSource_})
           {}
 
@@ -330,13 +402,67 @@ struct type_erased_stream {
     }
   };
 
-  std::unique_ptr<stream_base> stream_;
+  template <
+      typename ConcreteStream,
+      std::enable_if_t<
+          !std::is_same_v<
+              std::remove_cvref_t<ConcreteStream>,
+              basic_type_erased_stream>,
+          int> = 0>
+  explicit basic_type_erased_stream(ConcreteStream&& stream)
+    : basic_type_erased_stream(
+          std::allocator_arg,
+          std::allocator<std::byte>{},
+          (ConcreteStream &&) stream) {}
+
+  template <typename Allocator, typename ConcreteStream>
+  explicit basic_type_erased_stream(
+      std::allocator_arg_t,
+      const Allocator& alloc,
+      ConcreteStream&& stream) {
+    using stream_type = std::remove_cvref_t<ConcreteStream>;
+    if constexpr (fits_inline<stream_type>) {
+      (void)alloc;
+      stream_ = ::new (static_cast<void*>(buffer_))
+          inline_stream<stream_type>((ConcreteStream &&) stream);
+    } else {
+      using allocated_type = allocated_stream<stream_type, Allocator>;
+      using allocator_traits = typename allocated_type::allocator_traits;
+      typename allocated_type::allocator_type typedAlloc{alloc};
+      auto* ptr = allocator_traits::allocate(typedAlloc, 1);
+      try {
+        ::new (static_cast<void*>(ptr))
+            allocated_type{(ConcreteStream &&) stream, typedAlloc};
+      } catch (...) {
+        allocator_traits::deallocate(typedAlloc, ptr, 1);
+        throw;
+      }
+      stream_ = ptr;
+    }
+  }
+
+  basic_type_erased_stream(basic_type_erased_stream&& other) noexcept
+    : stream_(
+          other.stream_ != nullptr ? other.stream_->move_to(buffer_)
+                                   : nullptr) {
+    other.stream_ = nullptr;
+  }
+
+  basic_type_erased_stream& operator=(
+      basic_type_erased_stream&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.stream_ != nullptr) {
+        stream_ = other.stream_->move_to(buffer_);
+        other.stream_ = nullptr;
+      }
+    }
+    return *this;
+  }
 
-  template <typename ConcreteStream>
-  explicit type_erased_stream(ConcreteStream&& stream)
-      : stream_(std::make_unique<
-                concrete_stream<std::remove_cvref_t<ConcreteStream>>>(
-            (ConcreteStream &&) stream)) {}
+  ~basic_type_erased_stream() {
+    reset();
+  }
 
   next_sender next() noexcept {
     return next_sender{*stream_};
@@ -345,11 +471,31 @@ struct type_erased_stream {
   cleanup_sender cleanup() noexcept {
     return cleanup_sender{*stream_};
   }
+
+ private:
+  void reset() noexcept {
+    if (stream_ != nullptr) {
+      std::exchange(stream_, nullptr)->destroy();
+    }
+  }
+
+  stream_base* stream_ = nullptr;
+  alignas(std::max_align_t) std::byte buffer_[InlineSize > 0 ? InlineSize : 1];
 };
 
+template <typename... Values>
+using type_erased_stream =
+    basic_type_erased_stream<type_erased_stream_default_inline_size, Values...>;
+
 template <typename... Ts, typename Stream>
 type_erased_stream<Ts...> type_erase(Stream&& stream) {
   return type_erased_stream<Ts...>{(Stream &&) stream};
 }
 
+template <typename... Ts, typename Stream, typename Allocator>
+type_erased_stream<Ts...> type_erase(Stream&& stream, const Allocator& alloc) {
+  return type_erased_stream<Ts...>{
+      std::allocator_arg, alloc, (Stream &&) stream};
+}
+
 } // namespace unifex
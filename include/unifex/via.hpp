@@ -56,7 +56,7 @@ struct via_sender {
       return blocking_kind::never;
     } else if (
         predBlocking == blocking_kind::always_inline &&
-        predBlocking == blocking_kind::always_inline) {
+        succBlocking == blocking_kind::always_inline) {
       return blocking_kind::always_inline;
     } else if (
         (predBlocking == blocking_kind::always_inline ||
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/async_trace.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/type_traits.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace unifex {
+
+namespace detail {
+
+// The type that a single result of a sender is stored as.
+template <typename... Values>
+struct when_all_range_element {
+  using type = std::tuple<std::decay_t<Values>...>;
+};
+
+template <typename Value>
+struct when_all_range_element<Value> {
+  using type = std::decay_t<Value>;
+};
+
+template <>
+struct when_all_range_element<> {
+  using type = void;
+};
+
+template <typename... Overloads>
+struct when_all_range_single_overload {
+  static_assert(
+      sizeof...(Overloads) == 1,
+      "when_all_range() requires senders that always complete with the "
+      "same set of value types");
+};
+
+template <typename Overload>
+struct when_all_range_single_overload<Overload> {
+  using type = typename Overload::type;
+};
+
+// A bool result stored in a byte of its own. Elements of std::vector<bool>
+// share bytes so they can't be written concurrently.
+struct when_all_range_bool {
+  bool value = false;
+};
+
+} // namespace detail
+
+template <typename Sender>
+class when_all_range_sender {
+  // What each sender's value is stored as, or void if it has none.
+  using element_type = typename Sender::template value_types<
+      detail::when_all_range_single_overload,
+      detail::when_all_range_element>::type;
+
+ public:
+  // Completes with a std::vector of the results, in the same order as the
+  // senders, or with no values if the senders have none.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = std::conditional_t<
+      std::is_void_v<element_type>,
+      Variant<Tuple<>>,
+      Variant<Tuple<std::vector<non_void_t<element_type>>>>>;
+
+  template <template <typename...> class Variant>
+  using error_types = deduplicate_t<concat_lists_t<
+      Variant,
+      Variant<std::exception_ptr>,
+      typename Sender::template error_types<Variant>>>;
+
+  explicit when_all_range_sender(
+      std::vector<Sender> senders,
+      std::size_t maxConcurrency)
+    : senders_(std::move(senders)), maxConcurrency_(maxConcurrency) {}
+
+ private:
+  template <typename Receiver>
+  class operation {
+    static constexpr bool is_bool = std::is_same_v<element_type, bool>;
+
+    // Results are written straight into the vector that is passed on, unless
+    // they can't be default-constructed or they are bools.
+    static constexpr bool store_directly = std::is_void_v<element_type> ||
+        (std::is_default_constructible_v<non_void_t<element_type>> &&
+         !is_bool);
+
+    using stored_type = std::conditional_t<
+        store_directly,
+        non_void_t<element_type>,
+        std::conditional_t<
+            is_bool,
+            detail::when_all_range_bool,
+            std::optional<non_void_t<element_type>>>>;
+
+    struct cancel_operation {
+      operation& op_;
+
+      void operator()() noexcept {
+        op_.stopSource_.request_stop();
+      }
+    };
+
+    struct lane;
+
+    struct element_receiver {
+      lane& lane_;
+
+      template <typename... Values>
+      void value(Values&&... values) && noexcept {
+        lane& l = lane_;
+        try {
+          l.op_->store_value(l.index_, (Values &&) values...);
+        } catch (...) {
+          l.op_->record_error(std::current_exception());
+        }
+        l.child_completed();
+      }
+
+      template <typename Error>
+      void error(Error&& error) && noexcept {
+        lane& l = lane_;
+        l.op_->record_error((Error &&) error);
+        l.child_completed();
+      }
+
+      void done() && noexcept {
+        lane& l = lane_;
+        l.op_->record_done();
+        l.child_completed();
+      }
+
+      Receiver& get_receiver() const {
+        return lane_.op_->receiver_;
+      }
+
+      inplace_stop_source& get_stop_source() const {
+        return lane_.op_->stopSource_;
+      }
+
+      template <
+          typename CPO,
+          std::enable_if_t<!cpo::is_receiver_cpo_v<CPO>, int> = 0>
+      friend auto tag_invoke(CPO cpo, const element_receiver& r) noexcept(
+          std::is_nothrow_invocable_v<CPO, const Receiver&>)
+          -> std::invoke_result_t<CPO, const Receiver&> {
+        return std::move(cpo)(std::as_const(r.get_receiver()));
+      }
+
+      friend inplace_stop_token tag_invoke(
+          tag_t<get_stop_token>,
+          const element_receiver& r) noexcept {
+        return r.get_stop_source().get_token();
+      }
+
+      template <typename Func>
+      friend void tag_invoke(
+          tag_t<visit_continuations>,
+          const element_receiver& r,
+          Func&& func) {
+        std::invoke(func, r.get_receiver());
+      }
+    };
+
+    using child_operation = operation_t<Sender, element_receiver>;
+
+    // Runs the senders one at a time, taking the next sender that nobody
+    // has started from the shared index each time one completes. There is
+    // one lane per operation that may be outstanding at once.
+    struct lane {
+      // Start senders until one doesn't complete synchronously, or until
+      // there are none left.
+      void start_next() noexcept {
+        operation& op = *op_;
+        while (true) {
+          if (op.stopSource_.stop_requested()) {
+            break;
+          }
+          const std::size_t index =
+              op.nextIndex_.fetch_add(1, std::memory_order_relaxed);
+          if (index >= op.senders_.size()) {
+            break;
+          }
+
+          index_ = index;
+          try {
+            childOp_.construct_from([&] {
+              return cpo::connect(
+                  std::move(op.senders_[index]), element_receiver{*this});
+            });
+          } catch (...) {
+            op.record_error(std::current_exception());
+            break;
+          }
+
+          // If the child completes before start() returns it leaves
+          // starting the next sender to us rather than recursing.
+          starting_.store(true, std::memory_order_relaxed);
+          cpo::start(childOp_.get());
+          if (starting_.exchange(false, std::memory_order_acq_rel)) {
+            // It's still running, and will start the next sender itself.
+            return;
+          }
+        }
+        op.lane_finished();
+      }
+
+      void child_completed() noexcept {
+        childOp_.destruct();
+        if (starting_.exchange(false, std::memory_order_acq_rel)) {
+          // Completed synchronously inside start_next().
+          return;
+        }
+        start_next();
+      }
+
+      operation* op_ = nullptr;
+      std::size_t index_ = 0;
+      std::atomic<bool> starting_{false};
+      manual_lifetime<child_operation> childOp_;
+    };
+
+   public:
+    template <typename Receiver2>
+    explicit operation(
+        Receiver2&& receiver,
+        std::vector<Sender>&& senders,
+        std::size_t maxConcurrency)
+      : receiver_((Receiver2 &&) receiver),
+        senders_(std::move(senders)),
+        laneCount_(std::min(
+            senders_.size(), std::max<std::size_t>(maxConcurrency, 1))),
+        lanes_(new lane[laneCount_]),
+        activeLanes_(laneCount_) {
+      if constexpr (!std::is_void_v<element_type>) {
+        values_.resize(senders_.size());
+      }
+      for (std::size_t i = 0; i < laneCount_; ++i) {
+        lanes_[i].op_ = this;
+      }
+    }
+
+    operation(const operation&) = delete;
+    operation& operator=(const operation&) = delete;
+
+    void start() noexcept {
+      stopCallback_.construct(
+          get_stop_token(receiver_), cancel_operation{*this});
+      if (laneCount_ == 0) {
+        deliver_result();
+        return;
+      }
+
+      // The operation may complete, and be destroyed, once the last lane has
+      // started so don't touch any members after that.
+      lane* lanes = lanes_.get();
+      const std::size_t laneCount = laneCount_;
+      for (std::size_t i = 0; i < laneCount; ++i) {
+        lanes[i].start_next();
+      }
+    }
+
+   private:
+    template <typename... Values>
+    void store_value(std::size_t index, Values&&... values) {
+      if constexpr (std::is_void_v<element_type>) {
+        (void)index;
+      } else if constexpr (store_directly) {
+        values_[index] = element_type((Values &&) values...);
+      } else if constexpr (is_bool) {
+        values_[index].value = element_type((Values &&) values...);
+      } else {
+        values_[index].emplace((Values &&) values...);
+      }
+    }
+
+    template <typename Error>
+    void record_error(Error&& error) noexcept {
+      if (!doneOrError_.exchange(true, std::memory_order_relaxed)) {
+        error_.emplace(
+            std::in_place_type<std::decay_t<Error>>, (Error &&) error);
+        stopSource_.request_stop();
+      }
+    }
+
+    void record_done() noexcept {
+      if (!doneOrError_.exchange(true, std::memory_order_relaxed)) {
+        stopSource_.request_stop();
+      }
+    }
+
+    void lane_finished() noexcept {
+      if (activeLanes_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        deliver_result();
+      }
+    }
+
+    void deliver_result() noexcept {
+      stopCallback_.destruct();
+
+      if (get_stop_token(receiver_).stop_requested()) {
+        cpo::set_done(std::move(receiver_));
+      } else if (doneOrError_.load(std::memory_order_relaxed)) {
+        if (error_.has_value()) {
+          auto error = std::move(error_.value());
+          std::visit(
+              [this](auto&& error) {
+                cpo::set_error(std::move(receiver_), (decltype(error))error);
+              },
+              std::move(error));
+        } else {
+          cpo::set_done(std::move(receiver_));
+        }
+      } else {
+        deliver_value();
+      }
+    }
+
+    void deliver_value() noexcept {
+      // The receiver may destroy the operation so move the results out of
+      // it first.
+      try {
+        if constexpr (std::is_void_v<element_type>) {
+          cpo::set_value(std::move(receiver_));
+        } else if constexpr (store_directly) {
+          auto values = std::move(values_);
+          cpo::set_value(std::move(receiver_), std::move(values));
+        } else {
+          std::vector<element_type> values;
+          values.reserve(values_.size());
+          for (auto& value : values_) {
+            if constexpr (is_bool) {
+              values.push_back(value.value);
+            } else {
+              values.push_back(std::move(*value));
+            }
+          }
+          values_.clear();
+          cpo::set_value(std::move(receiver_), std::move(values));
+        }
+      } catch (...) {
+        cpo::set_error(std::move(receiver_), std::current_exception());
+      }
+    }
+
+    Receiver receiver_;
+    std::vector<Sender> senders_;
+    std::vector<stored_type> values_;
+    const std::size_t laneCount_;
+    std::unique_ptr<lane[]> lanes_;
+    std::atomic<std::size_t> nextIndex_{0};
+    std::atomic<std::size_t> activeLanes_;
+    std::optional<error_types<std::variant>> error_;
+    std::atomic<bool> doneOrError_{false};
+    inplace_stop_source stopSource_;
+    UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<typename stop_token_type_t<
+        Receiver&>::template callback_type<cancel_operation>>
+        stopCallback_;
+  };
+
+ public:
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& receiver) && {
+    return operation<std::remove_cvref_t<Receiver>>{
+        (Receiver &&) receiver, std::move(senders_), maxConcurrency_};
+  }
+
+ private:
+  std::vector<Sender> senders_;
+  std::size_t maxConcurrency_;
+};
+
+// Starts each of 'senders', with at most 'maxConcurrency' of them
+// outstanding at once, and completes with a vector of their results once
+// they have all completed.
+template <typename Sender>
+when_all_range_sender<Sender> when_all_range(
+    std::vector<Sender> senders,
+    std::size_t maxConcurrency = std::numeric_limits<std::size_t>::max()) {
+  return when_all_range_sender<Sender>{std::move(senders), maxConcurrency};
+}
+
+} // namespace unifex
@@ -0,0 +1,598 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <unifex/async_trace.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/manual_lifetime.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/type_traits.hpp>
+#include <unifex/when_all.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace unifex {
+
+namespace detail {
+
+template <template <typename...> class Tuple>
+struct when_any_decayed_tuple {
+  template <typename... Values>
+  using apply = Tuple<std::decay_t<Values>...>;
+};
+
+// The state shared by the children of a when_any() operation.
+//
+// The first child to complete with a value or an error wins. Its result is
+// stored here and the other children are asked to stop straight away. The
+// result is passed on once the last child has completed, as the children's
+// operation states live inside the operation and so must not be destroyed
+// before then. when_any_range() allocates its children instead so that it
+// can pass the result on straight away.
+template <typename Receiver, typename Values, typename Errors>
+class when_any_state {
+  struct cancel_operation {
+    when_any_state& state_;
+
+    void operator()() noexcept {
+      state_.stopSource_.request_stop();
+    }
+  };
+
+ public:
+  class element_receiver {
+   public:
+    explicit element_receiver(when_any_state& state) noexcept
+      : state_(state) {}
+
+    template <typename... Values2>
+    void value(Values2&&... values) && noexcept {
+      when_any_state& state = state_;
+      if (state.try_win()) {
+        try {
+          state.value_.template emplace<
+              std::tuple<std::decay_t<Values2>...>>((Values2 &&) values...);
+        } catch (...) {
+          state.error_.emplace(
+              std::in_place_type<std::exception_ptr>,
+              std::current_exception());
+        }
+      }
+      state.element_complete();
+    }
+
+    template <typename Error>
+    void error(Error&& error) && noexcept {
+      when_any_state& state = state_;
+      if (state.try_win()) {
+        state.error_.emplace(
+            std::in_place_type<std::decay_t<Error>>, (Error &&) error);
+      }
+      state.element_complete();
+    }
+
+    // A child that completes with done doesn't win, so that the others may
+    // still produce a result.
+    void done() && noexcept {
+      state_.element_complete();
+    }
+
+    Receiver& get_receiver() const {
+      return state_.receiver_;
+    }
+
+    inplace_stop_source& get_stop_source() const {
+      return state_.stopSource_;
+    }
+
+    template <
+        typename CPO,
+        std::enable_if_t<!cpo::is_receiver_cpo_v<CPO>, int> = 0>
+    friend auto tag_invoke(CPO cpo, const element_receiver& r) noexcept(
+        std::is_nothrow_invocable_v<CPO, const Receiver&>)
+        -> std::invoke_result_t<CPO, const Receiver&> {
+      return std::move(cpo)(std::as_const(r.get_receiver()));
+    }
+
+    friend inplace_stop_token tag_invoke(
+        tag_t<get_stop_token>,
+        const element_receiver& r) noexcept {
+      return r.get_stop_source().get_token();
+    }
+
+    template <typename Func>
+    friend void tag_invoke(
+        tag_t<visit_continuations>,
+        const element_receiver& r,
+        Func&& func) {
+      std::invoke(func, r.get_receiver());
+    }
+
+   private:
+    when_any_state& state_;
+  };
+
+  template <typename Receiver2>
+  explicit when_any_state(Receiver2&& receiver, std::size_t count)
+    : receiver_((Receiver2 &&) receiver), refCount_(count) {}
+
+  when_any_state(const when_any_state&) = delete;
+  when_any_state& operator=(const when_any_state&) = delete;
+
+  // Call before starting the children. Returns false if there are no
+  // children, in which case the result has already been delivered.
+  bool start() noexcept {
+    stopCallback_.construct(
+        get_stop_token(receiver_), cancel_operation{*this});
+    if (refCount_.load(std::memory_order_relaxed) == 0) {
+      deliver_result();
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  bool try_win() noexcept {
+    if (hasResult_.exchange(true, std::memory_order_relaxed)) {
+      return false;
+    }
+    stopSource_.request_stop();
+    return true;
+  }
+
+  void element_complete() noexcept {
+    if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      deliver_result();
+    }
+  }
+
+  void deliver_result() noexcept {
+    stopCallback_.destruct();
+
+    // The receiver may destroy the operation so move the result out of it
+    // first.
+    if (error_.has_value()) {
+      auto error = std::move(error_.value());
+      std::visit(
+          [this](auto&& error) {
+            cpo::set_error(std::move(receiver_), (decltype(error))error);
+          },
+          std::move(error));
+    } else if (value_.index() != 0) {
+      auto value = std::move(value_);
+      try {
+        std::visit(
+            [this](auto&& values) {
+              if constexpr (!std::is_same_v<
+                                std::decay_t<decltype(values)>,
+                                std::monostate>) {
+                std::apply(
+                    [this](auto&&... values) {
+                      cpo::set_value(
+                          std::move(receiver_), (decltype(values))values...);
+                    },
+                    (decltype(values))values);
+              }
+            },
+            std::move(value));
+      } catch (...) {
+        cpo::set_error(std::move(receiver_), std::current_exception());
+      }
+    } else {
+      cpo::set_done(std::move(receiver_));
+    }
+  }
+
+  Receiver receiver_;
+  Values value_;
+  std::optional<Errors> error_;
+  std::atomic<std::size_t> refCount_;
+  std::atomic<bool> hasResult_{false};
+  inplace_stop_source stopSource_;
+  UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<typename stop_token_type_t<
+      Receiver&>::template callback_type<cancel_operation>>
+      stopCallback_;
+};
+
+} // namespace detail
+
+template <typename... Senders>
+class when_any_sender {
+ public:
+  static_assert(sizeof...(Senders) > 0);
+
+  // Completes with the values of whichever sender won, so with any of the
+  // senders' sets of values.
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = deduplicate_t<concat_lists_t<
+      Variant,
+      typename Senders::template value_types<
+          Variant,
+          detail::when_any_decayed_tuple<Tuple>::template apply>...>>;
+
+  template <template <typename...> class Variant>
+  using error_types = deduplicate_t<concat_lists_t<
+      Variant,
+      Variant<std::exception_ptr>,
+      typename Senders::template error_types<Variant>...>>;
+
+  template <typename... Senders2>
+  explicit when_any_sender(Senders2&&... senders)
+    : senders_((Senders2 &&) senders...) {}
+
+ private:
+  template <typename Receiver>
+  class operation {
+    using state_type = detail::when_any_state<
+        Receiver,
+        deduplicate_t<concat_lists_t<
+            std::variant,
+            std::variant<std::monostate>,
+            value_types<std::variant, std::tuple>>>,
+        error_types<std::variant>>;
+
+    template <std::size_t Index>
+    using element_receiver = typename state_type::element_receiver;
+
+   public:
+    template <typename Receiver2>
+    explicit operation(Receiver2&& receiver, Senders&&... senders)
+      : state_((Receiver2 &&) receiver, sizeof...(Senders)),
+        ops_(state_, (Senders &&) senders...) {}
+
+    void start() noexcept {
+      state_.start();
+      ops_.start();
+    }
+
+   private:
+    state_type state_;
+    detail::when_all_operation_tuple<0, element_receiver, Senders...> ops_;
+  };
+
+ public:
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& receiver) && {
+    return std::apply(
+        [&](Senders&&... senders) {
+          return operation<std::remove_cvref_t<Receiver>>{
+              (Receiver &&) receiver, (Senders &&) senders...};
+        },
+        std::move(senders_));
+  }
+
+ private:
+  std::tuple<Senders...> senders_;
+};
+
+template <typename Sender>
+class when_any_range_sender {
+ public:
+  template <
+      template <typename...> class Variant,
+      template <typename...> class Tuple>
+  using value_types = typename Sender::template value_types<
+      Variant,
+      detail::when_any_decayed_tuple<Tuple>::template apply>;
+
+  template <template <typename...> class Variant>
+  using error_types = deduplicate_t<concat_lists_t<
+      Variant,
+      Variant<std::exception_ptr>,
+      typename Sender::template error_types<Variant>>>;
+
+  explicit when_any_range_sender(std::vector<Sender> senders)
+    : senders_(std::move(senders)) {}
+
+ private:
+  template <typename Receiver>
+  class operation {
+    class shared_state;
+
+    class element_receiver {
+     public:
+      explicit element_receiver(shared_state& state) noexcept
+        : state_(state) {}
+
+      template <typename... Values>
+      void value(Values&&... values) && noexcept {
+        shared_state& state = state_;
+        if (state.try_win()) {
+          state.deliver_value((Values &&) values...);
+        }
+        state.element_complete();
+      }
+
+      template <typename Error>
+      void error(Error&& error) && noexcept {
+        shared_state& state = state_;
+        if (state.try_win()) {
+          state.deliver_error((Error &&) error);
+        }
+        state.element_complete();
+      }
+
+      // A child that completes with done doesn't win, so that the others may
+      // still produce a result.
+      void done() && noexcept {
+        state_.element_complete();
+      }
+
+      inplace_stop_source& get_stop_source() const {
+        return state_.stopSource_;
+      }
+
+      // Other queries, and continuations, aren't forwarded to the receiver
+      // as the losers carry on after the winner has completed it, by which
+      // time it may refer to state that has gone.
+      friend inplace_stop_token tag_invoke(
+          tag_t<get_stop_token>,
+          const element_receiver& r) noexcept {
+        return r.get_stop_source().get_token();
+      }
+
+     private:
+      shared_state& state_;
+    };
+
+    using child_operation = operation_t<Sender, element_receiver>;
+
+    struct cancel_operation {
+      shared_state& state_;
+
+      void operator()() noexcept {
+        state_.stopSource_.request_stop();
+      }
+    };
+
+    // The receiver and the children's operation states, allocated together
+    // and owned jointly by the operation and by each child that hasn't
+    // completed yet. The winner passes its result on straight away and the
+    // losers release their share of the state once they have stopped.
+    class shared_state {
+     public:
+      template <typename Receiver2>
+      static shared_state* create(
+          Receiver2&& receiver,
+          std::vector<Sender>&& senders) {
+        const std::size_t count = senders.size();
+        void* storage = ::operator new(
+            ops_offset() + count * sizeof(child_slot), alignment());
+        shared_state* state;
+        try {
+          state = ::new (storage) shared_state((Receiver2 &&) receiver, count);
+        } catch (...) {
+          ::operator delete(storage, alignment());
+          throw;
+        }
+
+        try {
+          child_slot* ops = state->ops();
+          for (; state->opCount_ < count; ++state->opCount_) {
+            ::new (static_cast<void*>(ops + state->opCount_)) child_slot;
+            ops[state->opCount_].construct_from([&] {
+              return cpo::connect(
+                  std::move(senders[state->opCount_]),
+                  element_receiver{*state});
+            });
+          }
+        } catch (...) {
+          state->destroy();
+          throw;
+        }
+        return state;
+      }
+
+      shared_state(const shared_state&) = delete;
+      shared_state& operator=(const shared_state&) = delete;
+
+      void start() noexcept {
+        stopCallback_.construct(
+            get_stop_token(receiver_), cancel_operation{*this});
+        if (opCount_ == 0) {
+          deliver_done();
+          return;
+        }
+
+        // The state may be freed once the last child has started so don't
+        // touch any members after that.
+        child_slot* ops = this->ops();
+        const std::size_t opCount = opCount_;
+        for (std::size_t i = 0; i < opCount; ++i) {
+          cpo::start(ops[i].get());
+        }
+      }
+
+      // Drop a share of the state, freeing it if it was the last.
+      void release() noexcept {
+        if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          destroy();
+        }
+      }
+
+      // Free the state. Only valid once none of the children are running,
+      // either because they weren't started or because all of their shares
+      // have been released.
+      void destroy() noexcept {
+        child_slot* ops = this->ops();
+        for (std::size_t i = 0; i < opCount_; ++i) {
+          ops[i].destruct();
+        }
+        this->~shared_state();
+        ::operator delete(static_cast<void*>(this), alignment());
+      }
+
+     private:
+      friend element_receiver;
+      friend cancel_operation;
+
+      using child_slot = manual_lifetime<child_operation>;
+
+      // Where the children's operation states start within the allocation.
+      static constexpr std::size_t ops_offset() noexcept {
+        return (sizeof(shared_state) + alignof(child_slot) - 1) /
+            alignof(child_slot) * alignof(child_slot);
+      }
+
+      static constexpr std::align_val_t alignment() noexcept {
+        return std::align_val_t{std::max(
+            alignof(shared_state), alignof(child_slot))};
+      }
+
+      // One share for the operation and one for each child.
+      template <typename Receiver2>
+      explicit shared_state(Receiver2&& receiver, std::size_t count)
+        : receiver_((Receiver2 &&) receiver),
+          pendingCount_(count),
+          refCount_(count + 1) {}
+
+      ~shared_state() = default;
+
+      child_slot* ops() noexcept {
+        return std::launder(reinterpret_cast<child_slot*>(
+            reinterpret_cast<std::byte*>(this) + ops_offset()));
+      }
+
+      bool try_win() noexcept {
+        if (hasResult_.exchange(true, std::memory_order_relaxed)) {
+          return false;
+        }
+        stopSource_.request_stop();
+        return true;
+      }
+
+      void element_complete() noexcept {
+        // Hold on to our share until we're done with the state, as the
+        // others may be released concurrently.
+        if (pendingCount_.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+            !hasResult_.load(std::memory_order_relaxed)) {
+          // Every child completed with done.
+          deliver_done();
+        }
+        release();
+      }
+
+      template <typename... Values>
+      void deliver_value(Values&&... values) noexcept {
+        stopCallback_.destruct();
+        try {
+          // Pass on decayed copies, as value_types promises.
+          [this](std::decay_t<Values>... decayed) {
+            cpo::set_value(std::move(receiver_), std::move(decayed)...);
+          }((Values &&) values...);
+        } catch (...) {
+          cpo::set_error(std::move(receiver_), std::current_exception());
+        }
+      }
+
+      template <typename Error>
+      void deliver_error(Error&& error) noexcept {
+        stopCallback_.destruct();
+        cpo::set_error(std::move(receiver_), (Error &&) error);
+      }
+
+      void deliver_done() noexcept {
+        stopCallback_.destruct();
+        cpo::set_done(std::move(receiver_));
+      }
+
+      Receiver receiver_;
+      std::size_t opCount_ = 0;
+
+      // The number of children that haven't completed yet.
+      std::atomic<std::size_t> pendingCount_;
+
+      // The number of shares of the state still held.
+      std::atomic<std::size_t> refCount_;
+      std::atomic<bool> hasResult_{false};
+      inplace_stop_source stopSource_;
+      UNIFEX_NO_UNIQUE_ADDRESS manual_lifetime<typename stop_token_type_t<
+          Receiver&>::template callback_type<cancel_operation>>
+          stopCallback_;
+    };
+
+   public:
+    template <typename Receiver2>
+    explicit operation(Receiver2&& receiver, std::vector<Sender>&& senders)
+      : state_(shared_state::create(
+            (Receiver2 &&) receiver, std::move(senders))) {}
+
+    ~operation() {
+      if (started_) {
+        state_->release();
+      } else {
+        state_->destroy();
+      }
+    }
+
+    operation(const operation&) = delete;
+    operation& operator=(const operation&) = delete;
+
+    void start() noexcept {
+      started_ = true;
+      state_->start();
+    }
+
+   private:
+    shared_state* state_;
+    bool started_ = false;
+  };
+
+ public:
+  template <typename Receiver>
+  operation<std::remove_cvref_t<Receiver>> connect(Receiver&& receiver) && {
+    return operation<std::remove_cvref_t<Receiver>>{
+        (Receiver &&) receiver, std::move(senders_)};
+  }
+
+ private:
+  std::vector<Sender> senders_;
+};
+
+// Starts all of 'senders' and completes with the result of the first one to
+// complete with a value or an error, asking the others to stop as soon as
+// it does. Completes with done if they all complete with done.
+template <typename... Senders>
+when_any_sender<std::remove_cvref_t<Senders>...> when_any(
+    Senders&&... senders) {
+  return when_any_sender<std::remove_cvref_t<Senders>...>{
+      (Senders &&) senders...};
+}
+
+// Like when_any() but for a runtime-sized vector of senders of the same type.
+// Completes as soon as there is a winner, without waiting for the others to
+// stop. The senders' receivers only support get_stop_token() so they must
+// not need any other queries answered.
+template <typename Sender>
+when_any_range_sender<Sender> when_any_range(std::vector<Sender> senders) {
+  return when_any_range_sender<Sender>{std::move(senders)};
+}
+
+} // namespace unifex
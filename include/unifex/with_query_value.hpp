@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <unifex/async_trace.hpp>
 #include <unifex/get_allocator.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
@@ -59,6 +60,12 @@ class with_query_value_operation {
       return std::invoke(std::move(cpo), r.receiver_, (Args &&) args...);
     }
 
+    template <typename Func>
+    friend void tag_invoke(tag_t<visit_continuations>,
+                           const receiver_wrapper &r, Func &&func) {
+      std::invoke(func, r.receiver_);
+    }
+
     template <typename OtherCPO, typename... Args>
     friend auto
     tag_invoke(OtherCPO cpo, receiver_wrapper &&r, Args &&... args) noexcept(
@@ -85,7 +92,10 @@ public:
 
 private:
   UNIFEX_NO_UNIQUE_ADDRESS Value value_;
-  UNIFEX_NO_UNIQUE_ADDRESS operation_t<Sender, receiver_wrapper> innerOp_;
+  // Not UNIFEX_NO_UNIQUE_ADDRESS as that would stop the operation returned
+  // by connect() from being constructed in place, and operations needn't be
+  // movable.
+  operation_t<Sender, receiver_wrapper> innerOp_;
 };
 
 } // namespace detail
@@ -17,8 +17,10 @@
 
 #include <unifex/scope_guard.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <new>
 #include <system_error>
 
 #include <fcntl.h>
@@ -225,8 +227,10 @@
 // of the item onto a queue of remotely scheduled items.
 //
 // If the I/O thread becomes idle then it marks the queue with an
-// 'inactive consumer' flag and submits an IORING_OP_POLL_ADD operation on an
-// eventfd object.
+// 'inactive consumer' flag and makes sure there is an IORING_OP_POLL_ADD
+// operation outstanding on an eventfd object. Where supported this is a
+// multishot poll that stays armed across wakeups so that it only needs to be
+// submitted once.
 //
 // The next time a remote thread enqueues an item to the queue it will see and
 // clear this 'inactive consumer' flag and then signal the eventfd by writing
@@ -236,6 +240,14 @@
 // to the completion queue and wake-up the I/O thread which will then acquire
 // the list of remotely scheduled items and add them to the list of
 // ready-to-run operations.
+//
+// If the remote thread is itself the I/O thread of another io_uring_context
+// in the same wakeup group then it instead submits an IORING_OP_MSG_RING
+// operation on its own ring, which posts a completion event directly to our
+// completion queue. This avoids both the write() and the read() of the
+// eventfd. If the message fails then the sending context writes to our
+// eventfd when it sees the failed completion, which is why contexts in a
+// wakeup group must outlive each other's I/O loops.
 
 namespace unifex::linux {
 
@@ -243,15 +255,59 @@ static thread_local io_uring_context* currentThreadContext;
 
 static constexpr __u64 remote_queue_event_user_data = 0;
 
-io_uring_context::io_uring_context() {
+// The user_data of the completion event posted to a ring by another ring's
+// IORING_OP_MSG_RING to wake up its I/O thread.
+static constexpr __u64 remote_queue_message_user_data = 2;
+
+// Set in the user_data of an IORING_OP_MSG_RING operation on the sending
+// ring, which is otherwise the address of the io_uring_context to wake up.
+static constexpr std::uintptr_t remote_queue_message_tag = 1;
+
+io_uring_context::io_uring_context() : io_uring_context(options{}) {}
+
+io_uring_context::io_uring_context(const options& opts) {
   io_uring_params params;
   std::memset(&params, 0, sizeof(params));
 
-  int ret = io_uring_setup(256, &params);
+  params.flags = opts.setupFlags;
+  if (opts.completionQueueEntries != 0) {
+    params.flags |= IORING_SETUP_CQSIZE;
+    params.cq_entries = opts.completionQueueEntries;
+  }
+  if (opts.clampEntries) {
+    params.flags |= IORING_SETUP_CLAMP;
+  }
+  if (opts.submissionQueuePolling) {
+    params.flags |= IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = opts.submissionQueueThreadIdleMs;
+    if (opts.submissionQueueThreadCpu) {
+      params.flags |= IORING_SETUP_SQ_AFF;
+      params.sq_thread_cpu = *opts.submissionQueueThreadCpu;
+    }
+  }
+
+  int ret = io_uring_setup(opts.submissionQueueEntries, &params);
   if (ret < 0) {
     throw std::system_error{-ret, std::system_category()};
   }
   iouringFd_ = safe_file_descriptor{ret};
+  submissionQueuePolling_ = (params.flags & IORING_SETUP_SQPOLL) != 0;
+  wakeupGroup_ = opts.wakeupGroup;
+
+  {
+    // Find out whether other rings can wake us up with IORING_OP_MSG_RING.
+    // Kernels that don't support probing don't support it either.
+    constexpr std::size_t opCount = 256;
+    alignas(io_uring_probe) std::byte
+        buffer[sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op)] =
+            {};
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer);
+    int result = io_uring_register(
+        iouringFd_.get(), IORING_REGISTER_PROBE, probe, opCount);
+    messageRingSupported_ = result >= 0 &&
+        IORING_OP_MSG_RING <= probe->last_op &&
+        (probe->ops[IORING_OP_MSG_RING].flags & IO_URING_OP_SUPPORTED) != 0;
+  }
 
   {
     auto cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
@@ -352,6 +408,53 @@ io_uring_context::io_uring_context() {
     remoteQueueEventFd_ = safe_file_descriptor{fd};
   }
 
+  if (opts.registeredBufferSlots > 0) {
+    // Register an empty table of buffers that can later be filled in
+    // by register_buffer().
+    io_uring_rsrc_register reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.nr = opts.registeredBufferSlots;
+    reg.flags = IORING_RSRC_REGISTER_SPARSE;
+    int result = io_uring_register(
+        iouringFd_.get(), IORING_REGISTER_BUFFERS2, &reg, sizeof(reg));
+    if (result < 0) {
+      int errorCode = errno;
+      throw std::system_error{errorCode, std::system_category()};
+    }
+
+    registeredBuffers_ =
+        std::make_unique<registered_buffer[]>(opts.registeredBufferSlots);
+    registeredBufferSlotCount_ = opts.registeredBufferSlots;
+  }
+
+  if (opts.registeredFileSlots > 0) {
+    // Register an empty table of files that can later be filled in
+    // by register_file().
+    io_uring_rsrc_register reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.nr = opts.registeredFileSlots;
+    reg.flags = IORING_RSRC_REGISTER_SPARSE;
+    int result = io_uring_register(
+        iouringFd_.get(), IORING_REGISTER_FILES2, &reg, sizeof(reg));
+    if (result < 0) {
+      int errorCode = errno;
+      throw std::system_error{errorCode, std::system_category()};
+    }
+
+    // Hand out the lowest-numbered slots first.
+    freeFileSlots_.reserve(opts.registeredFileSlots);
+    for (std::uint32_t i = opts.registeredFileSlots; i > 0; --i) {
+      freeFileSlots_.push_back(i - 1);
+    }
+  }
+
+  if (opts.timerBackend == timer_backend::timing_wheel) {
+    const auto tick = std::max(
+        std::chrono::ceil<monotonic_clock::duration>(opts.timerWheelTick),
+        monotonic_clock::duration{1});
+    timerWheel_.emplace(monotonic_clock::now(), tick);
+  }
+
   LOG("io_uring_context construction done");
 }
 
@@ -371,6 +474,9 @@ void io_uring_context::run_impl(const bool& shouldStop) {
     execute_pending_local();
 
     if (shouldStop) {
+      // Make sure that anything already submitted reaches the kernel.
+      // This includes any wakeup messages for other contexts.
+      flush_submissions();
       break;
     }
 
@@ -385,7 +491,7 @@ void io_uring_context::run_impl(const bool& shouldStop) {
     // Only do this if we haven't submitted a poll operation for the
     // completion queue - in which case we'll just wait until we receive the
     // completion-queue item).
-    if (!remoteQueueReadSubmitted_) {
+    if (!remoteQueueInactive_) {
       acquire_remote_queued_items();
     }
 
@@ -396,25 +502,57 @@ void io_uring_context::run_impl(const bool& shouldStop) {
       item->execute_(item);
     }
 
+    if (submissionQueuePolling_) {
+      update_consumed_submissions();
+    }
+
+    pendingIoCountEstimate_.store(
+        pending_operation_count(), std::memory_order_relaxed);
+
     if (localQueue_.empty() || sqUnflushedCount_ > 0) {
-      const bool isIdle = sqUnflushedCount_ == 0 && localQueue_.empty();
+      // When the kernel is polling the submission queue we don't need to
+      // flush unconsumed entries ourselves so we can block waiting for
+      // completions even if there are some.
+      const bool isIdle = localQueue_.empty() &&
+          (sqUnflushedCount_ == 0 || submissionQueuePolling_);
       if (isIdle) {
-        if (!remoteQueueReadSubmitted_) {
+        if (!remoteQueueInactive_) {
           LOG("try_register_remote_queue_notification()");
-          remoteQueueReadSubmitted_ = try_register_remote_queue_notification();
+          remoteQueueInactive_ = try_register_remote_queue_notification();
         }
       }
 
       int minCompletionCount = 0;
       unsigned flags = 0;
       if (isIdle &&
-          (remoteQueueReadSubmitted_ ||
+          (remoteQueueInactive_ ||
            pending_operation_count() == cqEntryCount_)) {
         // No work to do until we receive a completion event.
         minCompletionCount = 1;
         flags = IORING_ENTER_GETEVENTS;
       }
 
+      if (submissionQueuePolling_) {
+        // The kernel thread picks up new entries by itself unless it has
+        // gone to sleep, in which case it sets IORING_SQ_NEED_WAKEUP.
+        // The fence orders our store to the SQ tail before the load of the
+        // flags, pairing with the kernel thread's barrier before it sleeps.
+        if (sqUnflushedCount_ > 0) {
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if ((sqFlags_->load(std::memory_order_relaxed) &
+               IORING_SQ_NEED_WAKEUP) != 0) {
+            LOG("submission queue polling thread needs wakeup");
+            flags |= IORING_ENTER_SQ_WAKEUP;
+          }
+        }
+
+        if (flags == 0) {
+          // Still have local work to do and the kernel thread is awake
+          // so there is no need to enter the kernel.
+          continue;
+        }
+      }
+
       LOGX(
           "io_uring_enter() - submit %u, wait for %i, pending %u\n",
           sqUnflushedCount_,
@@ -434,12 +572,59 @@ void io_uring_context::run_impl(const bool& shouldStop) {
 
       LOG("io_uring_enter() returned");
 
+      if (submissionQueuePolling_) {
+        // The result is not the number of entries the kernel thread has
+        // consumed. These are accounted for by update_consumed_submissions().
+        continue;
+      }
+
       sqUnflushedCount_ -= result;
       cqPendingCount_ += result;
     }
   }
 }
 
+void io_uring_context::flush_submissions() {
+  if (sqUnflushedCount_ == 0) {
+    return;
+  }
+
+  if (submissionQueuePolling_) {
+    // The kernel thread consumes the entries by itself once awake.
+    if ((sqFlags_->load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP) !=
+        0) {
+      io_uring_enter(iouringFd_.get(), 0, 0, IORING_ENTER_SQ_WAKEUP, nullptr);
+    }
+    return;
+  }
+
+  int result =
+      io_uring_enter(iouringFd_.get(), sqUnflushedCount_, 0, 0, nullptr);
+  if (result < 0) {
+    int errorCode = errno;
+    throw std::system_error{errorCode, std::system_category()};
+  }
+  sqUnflushedCount_ -= result;
+  cqPendingCount_ += result;
+}
+
+void io_uring_context::update_consumed_submissions() noexcept {
+  assert(submissionQueuePolling_);
+
+  // Entries between the SQ head and tail have not yet been consumed by
+  // the kernel thread. Everything else we published has been.
+  const auto tail = sqTail_->load(std::memory_order_relaxed);
+  const auto head = sqHead_->load(std::memory_order_acquire);
+  const std::uint32_t unconsumedCount = tail - head;
+  assert(unconsumedCount <= sqUnflushedCount_);
+
+  // Note that completions for these entries may already have been
+  // subtracted from cqPendingCount_, which can therefore have temporarily
+  // wrapped. The unsigned arithmetic still yields the correct total.
+  cqPendingCount_ += sqUnflushedCount_ - unconsumedCount;
+  sqUnflushedCount_ = unconsumedCount;
+}
+
 bool io_uring_context::is_running_on_io_thread() const noexcept {
   return this == currentThreadContext;
 }
@@ -466,7 +651,14 @@ void io_uring_context::schedule_remote(operation_base* op) noexcept {
   if (ioThreadWasInactive) {
     // We were the first to queue an item and the I/O thread is not
     // going to check the queue until we signal it that new items
-    // have been enqueued remotely by writing to the eventfd.
+    // have been enqueued remotely.
+    //
+    // If we're running on the I/O thread of another context then we can
+    // send it a message from our ring. Otherwise write to the eventfd.
+    auto* current = currentThreadContext;
+    if (current != nullptr && current->try_submit_remote_queue_wakeup(*this)) {
+      return;
+    }
     signal_remote_queue();
   }
 }
@@ -483,6 +675,14 @@ void io_uring_context::reschedule_pending_io(operation_base* op) noexcept {
 
 void io_uring_context::schedule_at_impl(schedule_at_operation* op) noexcept {
   assert(is_running_on_io_thread());
+  if (timerWheel_.has_value()) {
+    timerWheel_->insert(op);
+    if (!currentDueTime_ || op->dueTime_ < *currentDueTime_) {
+      timersAreDirty_ = true;
+    }
+    return;
+  }
+
   timers_.insert(op);
   if (timers_.top() == op) {
     timersAreDirty_ = true;
@@ -527,25 +727,46 @@ void io_uring_context::acquire_completion_queue_items() noexcept {
 
     operation_queue completionQueue;
 
+    // Completions that don't correspond to a submission we counted in
+    // cqPendingCount_.
+    std::uint32_t unaccountedCount = 0;
+
     for (std::uint32_t i = 0; i < count; ++i) {
       auto index = (cqHead + i) & mask;
       auto& cqe = cqEntries_[(cqHead + i) & mask];
 
       if (cqe.user_data == remote_queue_event_user_data) {
         LOG("got remote queue wakeup");
+        if ((cqe.flags & IORING_CQE_F_MORE) != 0) {
+          // The multishot poll is still armed and will produce more
+          // completions. Only its final completion is accounted for.
+          ++unaccountedCount;
+        } else {
+          remoteQueuePollArmed_ = false;
+        }
+
         if (cqe.res < 0) {
+          if (cqe.res == -EINVAL && remoteQueuePollMultishot_) {
+            // Kernel doesn't support multishot poll. Use one-shot polls.
+            LOG("multishot poll not supported");
+            remoteQueuePollMultishot_ = false;
+            on_remote_queue_wakeup();
+            continue;
+          }
+
           LOGX("remote queue wakeup failed err: %i\n", cqe.res);
 
-          // readv() operation failed.
+          // poll() operation failed.
           // TODO: What to do here?
           std::terminate();
         }
 
-        // Read the eventfd to clear the signal.
+        // Read the eventfd to clear the signal. This may find nothing if
+        // an earlier read already consumed the signal.
         __u64 buffer;
         ssize_t bytesRead =
             read(remoteQueueEventFd_.get(), &buffer, sizeof(buffer));
-        if (bytesRead < 0) {
+        if (bytesRead < 0 && errno != EAGAIN) {
           // read() failed
           int errorCode = errno;
           LOGX("read on eventfd failed with %i\n", errorCode);
@@ -553,11 +774,35 @@ void io_uring_context::acquire_completion_queue_items() noexcept {
           std::terminate();
         }
 
-        assert(bytesRead == sizeof(buffer));
+        assert(bytesRead < 0 || bytesRead == sizeof(buffer));
 
         // Skip processing this item and let the loop check
         // for the remote-queued items next time around.
-        remoteQueueReadSubmitted_ = false;
+        on_remote_queue_wakeup();
+        continue;
+      } else if (cqe.user_data == remote_queue_message_user_data) {
+        LOG("got remote queue wakeup message");
+
+        // Posted by another ring so we didn't account for it.
+        ++unaccountedCount;
+        on_remote_queue_wakeup();
+        continue;
+      } else if ((cqe.user_data & remote_queue_message_tag) != 0) {
+        // Completion of a wakeup message we sent to another ring.
+        if (cqe.res < 0) {
+          LOGX("remote queue wakeup message failed err: %i\n", cqe.res);
+
+          // Messages are only sent within a wakeup group, whose contexts
+          // outlive our I/O loop, so the target is still alive.
+          auto& target = *reinterpret_cast<io_uring_context*>(
+              static_cast<std::uintptr_t>(cqe.user_data) &
+              ~remote_queue_message_tag);
+
+          // The write can only fail if the eventfd's counter is saturated,
+          // in which case the target's poll has already fired.
+          [[maybe_unused]] int errorCode = target.try_signal_remote_queue();
+          assert(errorCode == 0 || errorCode == EAGAIN);
+        }
         continue;
       } else if (cqe.user_data == timer_user_data()) {
         LOGX("got timer completion result %i\n", cqe.res);
@@ -578,6 +823,14 @@ void io_uring_context::acquire_completion_queue_items() noexcept {
       } else if (cqe.user_data == remove_timer_user_data()) {
         // Ignore timer cancellation completion.
         continue;
+      } else if (cqe.user_data == cancel_user_data()) {
+        // Ignore I/O cancellation completion. The result of the cancelled
+        // operation is delivered through its own completion.
+        continue;
+      } else if (cqe.user_data == link_timeout_user_data()) {
+        // Ignore linked timeout completion. If the timeout elapsed then the
+        // operation it was linked to completes with -ECANCELED.
+        continue;
       }
 
       auto& completionState = *reinterpret_cast<completion_base*>(
@@ -594,12 +847,12 @@ void io_uring_context::acquire_completion_queue_items() noexcept {
 
     // Mark those completion queue entries as consumed.
     cqHead_->store(cqTail, std::memory_order_release);
-    cqPendingCount_ -= count;
+    cqPendingCount_ -= count - unaccountedCount;
   }
 }
 
 void io_uring_context::acquire_remote_queued_items() noexcept {
-  assert(!remoteQueueReadSubmitted_);
+  assert(!remoteQueueInactive_);
   auto items = remoteQueue_.dequeue_all();
   LOG(items.empty() ? "remote queue is empty"
                     : "acquired items from remote queue");
@@ -607,6 +860,17 @@ void io_uring_context::acquire_remote_queued_items() noexcept {
 }
 
 bool io_uring_context::try_register_remote_queue_notification() noexcept {
+  if (remoteQueuePollArmed_) {
+    // The multishot poll from an earlier registration is still armed
+    // so we only need to mark the queue as inactive.
+    auto queuedItems = remoteQueue_.try_mark_inactive_or_dequeue_all();
+    if (!queuedItems.empty()) {
+      schedule_local(std::move(queuedItems));
+      return false;
+    }
+    return true;
+  }
+
   // Check that we haven't already hit the limit of pending
   // I/O completion events.
   const auto populateRemoteQueuePollSqe = [this](io_uring_sqe & sqe) noexcept {
@@ -622,16 +886,53 @@ bool io_uring_context::try_register_remote_queue_notification() noexcept {
     sqe.fd = remoteQueueEventFd_.get();
     sqe.off = 0;
     sqe.addr = 0;
-    sqe.len = 0;
+    sqe.len = remoteQueuePollMultishot_ ? IORING_POLL_ADD_MULTI : 0;
     sqe.poll_events = POLL_IN;
     sqe.user_data = remote_queue_event_user_data;
-    sqe.__pad2[0] = sqe.__pad2[1] = sqe.__pad2[2] = 0;
 
     return true;
   };
 
   if (try_submit_io(populateRemoteQueuePollSqe)) {
     LOG("added eventfd poll to submission queue");
+    remoteQueuePollArmed_ = true;
+    return true;
+  }
+
+  return false;
+}
+
+void io_uring_context::on_remote_queue_wakeup() noexcept {
+  if (remoteQueueInactive_) {
+    // Normally whoever enqueued work has already marked the queue as active
+    // again. But the wakeup may be left over from an earlier signal, so make
+    // sure it is active before the queue is next checked.
+    (void)remoteQueue_.try_mark_active();
+    remoteQueueInactive_ = false;
+  }
+}
+
+bool io_uring_context::try_submit_remote_queue_wakeup(
+    io_uring_context& target) noexcept {
+  assert(&target != this);
+
+  if (!messageRingSupported_ || wakeupGroup_ == nullptr ||
+      wakeupGroup_ != target.wakeupGroup_) {
+    return false;
+  }
+
+  auto populateSqe = [&](io_uring_sqe & sqe) noexcept {
+    sqe.opcode = IORING_OP_MSG_RING;
+    sqe.fd = target.iouringFd_.get();
+    sqe.addr = IORING_MSG_DATA;
+    sqe.len = 0; // result of the posted completion
+    sqe.off = remote_queue_message_user_data;
+    sqe.user_data =
+        reinterpret_cast<std::uintptr_t>(&target) | remote_queue_message_tag;
+  };
+
+  if (try_submit_io(populateSqe)) {
+    LOG("added remote queue wakeup message to submission queue");
     return true;
   }
 
@@ -639,6 +940,15 @@ bool io_uring_context::try_register_remote_queue_notification() noexcept {
 }
 
 void io_uring_context::signal_remote_queue() {
+  int errorCode = try_signal_remote_queue();
+  if (errorCode != 0) {
+    // What to do here? Terminate/abort/ignore?
+    // Try to dequeue the item before returning?
+    throw std::system_error{errorCode, std::system_category()};
+  }
+}
+
+int io_uring_context::try_signal_remote_queue() noexcept {
   LOG("writing bytes to eventfd");
 
   // Notify eventfd() by writing a 64-bit integer to it.
@@ -646,19 +956,26 @@ void io_uring_context::signal_remote_queue() {
   ssize_t bytesWritten =
       write(remoteQueueEventFd_.get(), &value, sizeof(value));
   if (bytesWritten < 0) {
-    // What to do here? Terminate/abort/ignore?
-    // Try to dequeue the item before returning?
     LOG("error writing to remote queue eventfd");
-    int errorCode = errno;
-    throw std::system_error{errorCode, std::system_category()};
+    return errno;
   }
 
   assert(bytesWritten == sizeof(value));
+  return 0;
 }
 
 void io_uring_context::remove_timer(schedule_at_operation* op) noexcept {
   LOGX("remove_timer(%p)\n", (void*)op);
 
+  if (timerWheel_.has_value()) {
+    timerWheel_->remove(op);
+    if (timerWheel_->empty()) {
+      // Cancel the kernel timer.
+      timersAreDirty_ = true;
+    }
+    return;
+  }
+
   assert(!timers_.empty());
   if (timers_.top() == op) {
     timersAreDirty_ = true;
@@ -669,36 +986,53 @@ void io_uring_context::remove_timer(schedule_at_operation* op) noexcept {
 void io_uring_context::update_timers() noexcept {
   LOG("update_timers()");
 
-  // Reap any elapsed timers.
-  if (!timers_.empty()) {
-    time_point now = monotonic_clock::now();
-    while (!timers_.empty() && timers_.top()->dueTime_ <= now) {
-      schedule_at_operation* item = timers_.pop();
-
-      LOGX("dequeued elapsed timer %p\n", (void*)item);
-
-      if (item->canBeCancelled_) {
-        auto oldState = item->state_.fetch_add(
-            schedule_at_operation::timer_elapsed_flag,
-            std::memory_order_acq_rel);
-        if ((oldState & schedule_at_operation::cancel_pending_flag) != 0) {
-          LOGX("timer already cancelled\n");
-
-          // Timer has been cancelled by a remote thread.
-          // The other thread is responsible for enqueueing is operation onto
-          // the remoteQueue_.
-          continue;
-        }
+  const auto elapse = [this](schedule_at_operation* item) noexcept {
+    LOGX("dequeued elapsed timer %p\n", (void*)item);
+
+    if (item->canBeCancelled_) {
+      auto oldState = item->state_.fetch_add(
+          schedule_at_operation::timer_elapsed_flag,
+          std::memory_order_acq_rel);
+      if ((oldState & schedule_at_operation::cancel_pending_flag) != 0) {
+        LOGX("timer already cancelled\n");
+
+        // Timer has been cancelled by a remote thread.
+        // The other thread is responsible for enqueueing is operation onto
+        // the remoteQueue_.
+        return;
       }
+    }
+
+    // Otherwise, we are responsible for enqueuing the timer onto the
+    // ready-to-run queue.
+    schedule_local(item);
+  };
 
-      // Otherwise, we are responsible for enqueuing the timer onto the
-      // ready-to-run queue.
-      schedule_local(item);
+  // Reap any elapsed timers.
+  std::optional<time_point> earliestDueTime;
+  if (timerWheel_.has_value()) {
+    if (!timerWheel_->empty()) {
+      // Timers elapse a whole tick at a time.
+      auto elapsed = timerWheel_->pop_expired(monotonic_clock::now());
+      while (!elapsed.empty()) {
+        elapse(elapsed.pop_front());
+      }
+    }
+    earliestDueTime = timerWheel_->next_expiry_time();
+  } else {
+    if (!timers_.empty()) {
+      time_point now = monotonic_clock::now();
+      while (!timers_.empty() && timers_.top()->dueTime_ <= now) {
+        elapse(timers_.pop());
+      }
+    }
+    if (!timers_.empty()) {
+      earliestDueTime = timers_.top()->dueTime_;
     }
   }
 
   // Check if we need to cancel or start some new OS timers.
-  if (timers_.empty()) {
+  if (!earliestDueTime) {
     if (currentDueTime_.has_value()) {
       LOG("no more schedule_at requests, cancelling timer");
 
@@ -709,18 +1043,16 @@ void io_uring_context::update_timers() noexcept {
       }
     }
   } else {
-    const auto earliestDueTime = timers_.top()->dueTime_;
-
     if (currentDueTime_) {
       constexpr auto threshold = std::chrono::microseconds(1);
-      if (earliestDueTime < (*currentDueTime_ - threshold)) {
+      if (*earliestDueTime < (*currentDueTime_ - threshold)) {
         LOG("active timer, need to cancel and submit an earlier one");
 
         // An earlier time has been scheduled.
         // Cancel the old timer before submitting a new one.
         if (try_submit_timer_io_cancel()) {
           currentDueTime_.reset();
-          if (try_submit_timer_io(earliestDueTime)) {
+          if (try_submit_timer_io(*earliestDueTime)) {
             currentDueTime_ = earliestDueTime;
             timersAreDirty_ = false;
           }
@@ -731,7 +1063,7 @@ void io_uring_context::update_timers() noexcept {
     } else {
       // No active timer, submit a new timer
       LOG("no active timer, trying to submit a new one");
-      if (try_submit_timer_io(earliestDueTime)) {
+      if (try_submit_timer_io(*earliestDueTime)) {
         currentDueTime_ = earliestDueTime;
         timersAreDirty_ = false;
       }
@@ -751,7 +1083,6 @@ bool io_uring_context::try_submit_timer_io(const time_point& dueTime) noexcept {
     sqe.rw_flags =
         1; // HACK: Should be 'sqe.timeout_flags = IORING_TIMEOUT_ABS'
     sqe.user_data = timer_user_data();
-    sqe.__pad2[0] = sqe.__pad2[1] = sqe.__pad2[2] = 0;
 
     time_.tv_sec = dueTime.seconds_part();
     time_.tv_nsec = dueTime.nanoseconds_part();
@@ -776,12 +1107,200 @@ bool io_uring_context::try_submit_timer_io_cancel() noexcept {
     sqe.len = 0;
     sqe.rw_flags = 0;
     sqe.user_data = remove_timer_user_data();
-    sqe.__pad2[0] = sqe.__pad2[1] = sqe.__pad2[2] = 0;
   };
 
   return try_submit_io(populateSqe);
 }
 
+std::uint32_t io_uring_context::register_buffer(span<std::byte> buffer) {
+  assert(buffer.data() != nullptr);
+
+  std::lock_guard lock{registeredBuffersMutex_};
+
+  std::uint32_t index = 0;
+  while (index < registeredBufferSlotCount_ &&
+         registeredBuffers_[index].begin_.load(std::memory_order_relaxed) !=
+             0) {
+    ++index;
+  }
+  if (index == registeredBufferSlotCount_) {
+    throw std::system_error{ENOBUFS, std::system_category()};
+  }
+
+  iovec iov;
+  iov.iov_base = buffer.data();
+  iov.iov_len = buffer.size();
+
+  io_uring_rsrc_update2 update;
+  std::memset(&update, 0, sizeof(update));
+  update.offset = index;
+  update.data = reinterpret_cast<std::uintptr_t>(&iov);
+  update.nr = 1;
+
+  int result = io_uring_register(
+      iouringFd_.get(),
+      IORING_REGISTER_BUFFERS_UPDATE,
+      &update,
+      sizeof(update));
+  if (result < 0) {
+    int errorCode = errno;
+    throw std::system_error{errorCode, std::system_category()};
+  }
+
+  // Publish the size before the address as the I/O thread treats a
+  // non-zero address as meaning the slot is in use.
+  auto& slot = registeredBuffers_[index];
+  slot.size_.store(buffer.size(), std::memory_order_relaxed);
+  slot.begin_.store(
+      reinterpret_cast<std::uintptr_t>(buffer.data()),
+      std::memory_order_release);
+  if (index >= registeredBufferEnd_.load(std::memory_order_relaxed)) {
+    registeredBufferEnd_.store(index + 1, std::memory_order_release);
+  }
+  registeredBufferCount_.fetch_add(1, std::memory_order_release);
+
+  return index;
+}
+
+void io_uring_context::unregister_buffer(std::uint32_t index) noexcept {
+  assert(index < registeredBufferSlotCount_);
+
+  std::lock_guard lock{registeredBuffersMutex_};
+
+  auto& slot = registeredBuffers_[index];
+  slot.begin_.store(0, std::memory_order_relaxed);
+  slot.size_.store(0, std::memory_order_relaxed);
+  registeredBufferCount_.fetch_sub(1, std::memory_order_relaxed);
+  std::uint32_t end = registeredBufferEnd_.load(std::memory_order_relaxed);
+  while (end > 0 &&
+         registeredBuffers_[end - 1].begin_.load(std::memory_order_relaxed) ==
+             0) {
+    --end;
+  }
+  registeredBufferEnd_.store(end, std::memory_order_relaxed);
+
+  // Updating the slot with an empty buffer removes the registration.
+  iovec iov;
+  iov.iov_base = nullptr;
+  iov.iov_len = 0;
+
+  io_uring_rsrc_update2 update;
+  std::memset(&update, 0, sizeof(update));
+  update.offset = index;
+  update.data = reinterpret_cast<std::uintptr_t>(&iov);
+  update.nr = 1;
+
+  [[maybe_unused]] int result = io_uring_register(
+      iouringFd_.get(),
+      IORING_REGISTER_BUFFERS_UPDATE,
+      &update,
+      sizeof(update));
+  LOGX("unregister_buffer(%u) returned %i\n", index, result);
+}
+
+std::uint32_t io_uring_context::register_file(int fd) {
+  std::lock_guard lock{registeredFilesMutex_};
+
+  if (freeFileSlots_.empty()) {
+    throw std::system_error{ENFILE, std::system_category()};
+  }
+
+  const std::uint32_t index = freeFileSlots_.back();
+
+  io_uring_rsrc_update2 update;
+  std::memset(&update, 0, sizeof(update));
+  update.offset = index;
+  update.data = reinterpret_cast<std::uintptr_t>(&fd);
+  update.nr = 1;
+
+  int result = io_uring_register(
+      iouringFd_.get(), IORING_REGISTER_FILES_UPDATE2, &update, sizeof(update));
+  if (result < 0) {
+    int errorCode = errno;
+    throw std::system_error{errorCode, std::system_category()};
+  }
+
+  freeFileSlots_.pop_back();
+  return index;
+}
+
+void io_uring_context::unregister_file(std::uint32_t index) noexcept {
+  std::lock_guard lock{registeredFilesMutex_};
+
+  // Updating the slot with -1 removes the registration.
+  int fd = -1;
+
+  io_uring_rsrc_update2 update;
+  std::memset(&update, 0, sizeof(update));
+  update.offset = index;
+  update.data = reinterpret_cast<std::uintptr_t>(&fd);
+  update.nr = 1;
+
+  [[maybe_unused]] int result = io_uring_register(
+      iouringFd_.get(), IORING_REGISTER_FILES_UPDATE2, &update, sizeof(update));
+  LOGX("unregister_file(%u) returned %i\n", index, result);
+
+  // Capacity was reserved up-front so this cannot throw.
+  freeFileSlots_.push_back(index);
+}
+
+io_uring_context::registered_buffer_pool::registered_buffer_pool(
+    io_uring_context& context,
+    std::size_t blockSize,
+    std::size_t blockCount)
+  : context_(context), blockSize_(blockSize) {
+  assert(blockSize > 0 && blockCount > 0);
+
+  const auto regionSize = blockSize * blockCount;
+  void* ptr = mmap(
+      0,
+      regionSize,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+      -1,
+      0);
+  if (ptr == MAP_FAILED) {
+    int errorCode = errno;
+    throw std::system_error{errorCode, std::system_category()};
+  }
+
+  region_ = mmap_region{ptr, regionSize};
+
+  bufferIndex_ = context_.register_buffer(
+      span<std::byte>{static_cast<std::byte*>(ptr), regionSize});
+
+  freeBlocks_.reserve(blockCount);
+  for (std::size_t i = blockCount; i > 0; --i) {
+    freeBlocks_.push_back(static_cast<std::byte*>(ptr) + (i - 1) * blockSize);
+  }
+}
+
+io_uring_context::registered_buffer_pool::~registered_buffer_pool() {
+  context_.unregister_buffer(bufferIndex_);
+}
+
+span<std::byte> io_uring_context::registered_buffer_pool::allocate() {
+  std::lock_guard lock{mutex_};
+  if (freeBlocks_.empty()) {
+    throw std::bad_alloc{};
+  }
+  std::byte* block = freeBlocks_.back();
+  freeBlocks_.pop_back();
+  return span<std::byte>{block, blockSize_};
+}
+
+void io_uring_context::registered_buffer_pool::deallocate(
+    span<std::byte> block) noexcept {
+  assert(block.size() == blockSize_);
+  assert(
+      block.data() >= static_cast<std::byte*>(region_.data()) &&
+      block.data() < static_cast<std::byte*>(region_.data()) + region_.size());
+
+  std::lock_guard lock{mutex_};
+  // Capacity was reserved up-front so this cannot throw.
+  freeBlocks_.push_back(block.data());
+}
+
 io_uring_context::async_read_only_file tag_invoke(
     tag_t<open_file_read_only>,
     io_uring_context::scheduler scheduler,
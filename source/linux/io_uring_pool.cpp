@@ -0,0 +1,220 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/linux/io_uring_pool.hpp>
+
+#include <algorithm>
+#include <future>
+#include <system_error>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace unifex::linux {
+
+namespace {
+
+thread_local const io_uring_pool* currentPool = nullptr;
+thread_local io_uring_context* currentPoolContext = nullptr;
+
+// The CPUs that the calling thread is allowed to run on.
+std::vector<int> allowed_cpus() {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (::sched_getaffinity(0, sizeof(cpus), &cpus) != 0) {
+    int errorCode = errno;
+    throw std::system_error{errorCode, std::system_category()};
+  }
+
+  std::vector<int> result;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &cpus)) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+void pin_current_thread(int cpu) {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  int result = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+  if (result != 0) {
+    throw std::system_error{result, std::system_category()};
+  }
+}
+
+int open_file(const filesystem::path& path, int flags) {
+  int result = ::open(path.c_str(), flags);
+  if (result < 0) {
+    int errorCode = errno;
+    throw std::system_error{errorCode, std::system_category()};
+  }
+  return result;
+}
+
+} // namespace
+
+io_uring_pool::io_uring_pool() : io_uring_pool(options{}) {}
+
+io_uring_pool::io_uring_pool(const options& opts)
+  : placement_(opts.placement) {
+  const std::vector<int> cpus = allowed_cpus();
+  const std::size_t ringCount = opts.ringCount != 0
+      ? opts.ringCount
+      : std::max<std::size_t>(cpus.size(), 1);
+
+  rings_.reserve(ringCount);
+  for (std::size_t i = 0; i < ringCount; ++i) {
+    rings_.push_back(std::make_unique<ring>());
+  }
+
+  // Each ring is created on the thread that drives it, after that thread
+  // has been pinned, so that the ring's memory is allocated on and its
+  // kernel-side state is associated with the CPU that will use it.
+  std::vector<std::future<void>> ready;
+  ready.reserve(ringCount);
+
+  // The rings all live until every thread has been joined so they can
+  // wake each other up with messages.
+  io_uring_context::options contextOptions = opts.contextOptions;
+  contextOptions.wakeupGroup = this;
+
+  try {
+    for (std::size_t i = 0; i < ringCount; ++i) {
+      const int cpu = opts.pinThreads && !cpus.empty()
+          ? cpus[i % cpus.size()]
+          : -1;
+      std::promise<void> created;
+      ready.push_back(created.get_future());
+
+      ring& r = *rings_[i];
+      r.thread_ = std::thread{[this,
+                               &r,
+                               cpu,
+                               contextOptions,
+                               created = std::move(created)]() mutable {
+        try {
+          if (cpu >= 0) {
+            pin_current_thread(cpu);
+          }
+          r.context_.emplace(contextOptions);
+        } catch (...) {
+          created.set_exception(std::current_exception());
+          return;
+        }
+        created.set_value();
+
+        currentPool = this;
+        currentPoolContext = &*r.context_;
+        r.context_->run(stopSource_.get_token());
+      }};
+    }
+
+    // Rethrows the first failure to pin a thread or to create its ring.
+    for (auto& f : ready) {
+      f.get();
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+}
+
+io_uring_pool::~io_uring_pool() {
+  stop();
+}
+
+void io_uring_pool::stop() noexcept {
+  stopSource_.request_stop();
+  for (auto& r : rings_) {
+    if (r->thread_.joinable()) {
+      r->thread_.join();
+    }
+  }
+}
+
+io_uring_context* io_uring_pool::current_context() const noexcept {
+  return currentPool == this ? currentPoolContext : nullptr;
+}
+
+io_uring_context& io_uring_pool::select_context() noexcept {
+  if (auto* local = current_context()) {
+    return *local;
+  }
+  return least_pending_context();
+}
+
+io_uring_context& io_uring_pool::select_context(int fd) noexcept {
+  if (auto* local = current_context()) {
+    return *local;
+  }
+  if (placement_ == placement_policy::hash_by_fd) {
+    return rings_[static_cast<std::size_t>(fd) % rings_.size()]->context();
+  }
+  return least_pending_context();
+}
+
+io_uring_context& io_uring_pool::least_pending_context() noexcept {
+  const std::size_t count = rings_.size();
+  const std::size_t start =
+      nextRing_.fetch_add(1, std::memory_order_relaxed) % count;
+
+  std::size_t best = start;
+  std::uint32_t bestPending =
+      rings_[best]->context().pending_io_count_estimate();
+  for (std::size_t i = 1; i < count && bestPending > 0; ++i) {
+    const std::size_t index = (start + i) % count;
+    const std::uint32_t pending =
+        rings_[index]->context().pending_io_count_estimate();
+    if (pending < bestPending) {
+      best = index;
+      bestPending = pending;
+    }
+  }
+
+  return rings_[best]->context();
+}
+
+io_uring_context::async_read_only_file tag_invoke(
+    tag_t<open_file_read_only>,
+    io_uring_pool::scheduler scheduler,
+    const filesystem::path& path) {
+  int fd = open_file(path, O_RDONLY | O_CLOEXEC);
+  return io_uring_context::async_read_only_file{
+      scheduler.pool_->select_context(fd), fd};
+}
+
+io_uring_context::async_write_only_file tag_invoke(
+    tag_t<open_file_write_only>,
+    io_uring_pool::scheduler scheduler,
+    const filesystem::path& path) {
+  int fd = open_file(path, O_WRONLY | O_CREAT | O_CLOEXEC);
+  return io_uring_context::async_write_only_file{
+      scheduler.pool_->select_context(fd), fd};
+}
+
+io_uring_context::async_read_write_file tag_invoke(
+    tag_t<open_file_read_write>,
+    io_uring_pool::scheduler scheduler,
+    const filesystem::path& path) {
+  int fd = open_file(path, O_RDWR | O_CREAT | O_CLOEXEC);
+  return io_uring_context::async_read_write_file{
+      scheduler.pool_->select_context(fd), fd};
+}
+
+} // namespace unifex::linux
@@ -15,42 +15,71 @@
  */
 #include <unifex/manual_event_loop.hpp>
 
+#include <thread>
+
 namespace unifex {
 
 void manual_event_loop::run() {
-  std::unique_lock lock{mutex_};
+  run_until(stop_);
+}
+
+void manual_event_loop::run_until(const std::atomic<bool>& stop) {
+  // A previous call may have returned with the queue marked inactive.
+  (void)queue_.try_mark_active();
+
   while (true) {
-    while (head_ == nullptr) {
-      if (stop_) return;
-      cv_.wait(lock);
+    auto tasks = queue_.dequeue_all();
+    if (tasks.empty()) {
+      tasks = queue_.try_mark_inactive_or_dequeue_all();
+      if (tasks.empty()) {
+        // The queue is now marked inactive so the next enqueue() will wake
+        // us up.
+        if (stop.load(std::memory_order_acquire)) {
+          // A producer may have woken us up and still be in the middle of
+          // wake_up(). The loop may be destroyed once we return so wait for
+          // it to finish.
+          while (notifying_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+          }
+          return;
+        }
+        wakeUp_.wait(false, std::memory_order_acquire);
+
+        // An exchange rather than a store so that we see everything written
+        // before any wake-up that we clear here.
+        (void)wakeUp_.exchange(false, std::memory_order_acquire);
+
+        // If we were woken by stop() then nobody has marked the queue as
+        // active again yet.
+        (void)queue_.try_mark_active();
+        continue;
+      }
     }
-    auto* task = head_;
-    head_ = task->next_;
-    if (head_ == nullptr) {
-      tail_ = nullptr;
+
+    while (!tasks.empty()) {
+      tasks.pop_front()->execute();
     }
-    lock.unlock();
-    task->execute();
-    lock.lock();
   }
 }
 
 void manual_event_loop::stop() {
-  std::unique_lock lock{mutex_};
-  stop_ = true;
-  cv_.notify_all();
+  stop_.store(true, std::memory_order_release);
+  wake_up();
 }
 
-void manual_event_loop::enqueue(task_base* task) {
-  std::unique_lock lock{mutex_};
-  if (head_ == nullptr) {
-    head_ = task;
-  } else {
-    tail_->next_ = task;
+void manual_event_loop::enqueue(task_base* task) noexcept {
+  if (queue_.enqueue(task)) {
+    wake_up();
   }
-  tail_ = task;
-  task->next_ = nullptr;
-  cv_.notify_one();
+}
+
+void manual_event_loop::wake_up() noexcept {
+  // Counted before the wake-up is published so that run() sees it if it
+  // sees the wake-up.
+  notifying_.fetch_add(1, std::memory_order_relaxed);
+  wakeUp_.store(true, std::memory_order_release);
+  wakeUp_.notify_one();
+  notifying_.fetch_sub(1, std::memory_order_release);
 }
 
 } // unifex
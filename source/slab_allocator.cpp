@@ -0,0 +1,203 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/slab_allocator.hpp>
+
+#include <cassert>
+#include <mutex>
+#include <new>
+
+namespace unifex {
+
+namespace {
+
+// Size classes are the powers of two from min_block_size to max_block_size.
+constexpr std::size_t min_block_size = 64;
+constexpr std::size_t size_class_count = 7;
+constexpr std::size_t max_block_size =
+    min_block_size << (size_class_count - 1);
+
+constexpr std::size_t slab_size = 64 * 1024;
+
+// How many blocks move between a thread's cache and the shared pool at a
+// time, and how many a thread caches before giving a batch back.
+constexpr std::size_t batch_size = 32;
+constexpr std::size_t max_cached_blocks = 2 * batch_size;
+
+static_assert(slab_size % max_block_size == 0);
+static_assert(min_block_size % alignof(std::max_align_t) == 0);
+
+std::size_t size_class(std::size_t size) noexcept {
+  std::size_t sizeClass = 0;
+  while ((min_block_size << sizeClass) < size) {
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+
+struct free_block {
+  free_block* next_;
+};
+
+// A list of free blocks of one size class.
+struct free_list {
+  void push(free_block* block) noexcept {
+    block->next_ = head_;
+    head_ = block;
+    ++count_;
+  }
+
+  free_block* pop() noexcept {
+    free_block* block = head_;
+    head_ = block->next_;
+    --count_;
+    return block;
+  }
+
+  // Move up to 'count' blocks from the front of 'other' to the front of
+  // this list.
+  void take(free_list& other, std::size_t count) noexcept {
+    for (; count > 0 && other.head_ != nullptr; --count) {
+      push(other.pop());
+    }
+  }
+
+  free_block* head_ = nullptr;
+  std::size_t count_ = 0;
+};
+
+// The blocks that aren't in any thread's cache.
+//
+// Never destroyed, as blocks may still be freed during static destruction.
+class shared_pool {
+ public:
+  static shared_pool& instance() {
+    static shared_pool* pool = new shared_pool;
+    return *pool;
+  }
+
+  // Move a batch of blocks into 'list', carving a new slab if there aren't
+  // any free.
+  void take_batch(std::size_t sizeClass, free_list& list) {
+    size_class_pool& pool = pools_[sizeClass];
+    std::lock_guard lock{pool.mutex_};
+    if (pool.blocks_.head_ == nullptr) {
+      const std::size_t blockSize = min_block_size << sizeClass;
+      auto* slab = static_cast<std::byte*>(::operator new(slab_size));
+      for (std::size_t offset = slab_size; offset > 0; offset -= blockSize) {
+        pool.blocks_.push(::new (slab + offset - blockSize) free_block);
+      }
+    }
+    list.take(pool.blocks_, batch_size);
+  }
+
+  // Move up to 'count' blocks from 'list' back into the pool.
+  void give_back(
+      std::size_t sizeClass,
+      free_list& list,
+      std::size_t count) noexcept {
+    size_class_pool& pool = pools_[sizeClass];
+    std::lock_guard lock{pool.mutex_};
+    pool.blocks_.take(list, count);
+  }
+
+ private:
+  struct size_class_pool {
+    std::mutex mutex_;
+    free_list blocks_;
+  };
+
+  size_class_pool pools_[size_class_count];
+};
+
+class thread_cache {
+ public:
+  constexpr thread_cache() noexcept = default;
+
+  ~thread_cache();
+
+  void* allocate(std::size_t sizeClass) {
+    free_list& list = lists_[sizeClass];
+    if (list.head_ == nullptr) {
+      shared_pool::instance().take_batch(sizeClass, list);
+    }
+    return list.pop();
+  }
+
+  void deallocate(void* p, std::size_t sizeClass) noexcept {
+    free_list& list = lists_[sizeClass];
+    list.push(::new (p) free_block);
+    if (list.count_ > max_cached_blocks) {
+      shared_pool::instance().give_back(sizeClass, list, batch_size);
+    }
+  }
+
+ private:
+  free_list lists_[size_class_count];
+};
+
+thread_local thread_cache cache;
+
+// Set once this thread's cache has been destroyed, in case blocks are
+// allocated or freed by destructors of other thread_locals after that.
+thread_local bool cacheDestroyed = false;
+
+thread_cache::~thread_cache() {
+  for (std::size_t sizeClass = 0; sizeClass < size_class_count; ++sizeClass) {
+    free_list& list = lists_[sizeClass];
+    shared_pool::instance().give_back(sizeClass, list, list.count_);
+  }
+  cacheDestroyed = true;
+}
+
+} // namespace
+
+namespace detail {
+
+void* slab_allocate(std::size_t size) {
+  if (size > max_block_size) {
+    return ::operator new(size);
+  }
+
+  const std::size_t sizeClass = size_class(size);
+  if (cacheDestroyed) {
+    free_list list;
+    shared_pool::instance().take_batch(sizeClass, list);
+    void* p = list.pop();
+    shared_pool::instance().give_back(sizeClass, list, list.count_);
+    return p;
+  }
+  return cache.allocate(sizeClass);
+}
+
+void slab_deallocate(void* p, std::size_t size) noexcept {
+  if (size > max_block_size) {
+    ::operator delete(p);
+    return;
+  }
+
+  const std::size_t sizeClass = size_class(size);
+  if (cacheDestroyed) {
+    free_list list;
+    list.push(::new (p) free_block);
+    shared_pool::instance().give_back(sizeClass, list, 1);
+    return;
+  }
+  cache.deallocate(p, sizeClass);
+}
+
+} // namespace detail
+
+} // namespace unifex
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unifex/static_thread_pool.hpp>
+
+#include <unifex/detail/chase_lev_deque.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace unifex {
+
+namespace {
+
+// How many times in a row a worker runs the task in its LIFO slot before
+// giving the rest of its local work a turn.
+constexpr std::uint32_t max_lifo_runs = 16;
+
+// How often a busy worker checks the shared queue before its own work, so
+// that work from outside the pool isn't starved by work the pool keeps
+// generating for itself.
+constexpr std::uint32_t remote_check_interval = 61;
+
+// The most tasks a worker moves from the shared queue to its own deque in
+// one go.
+constexpr std::size_t max_remote_batch = 32;
+
+} // namespace
+
+class alignas(64) static_thread_pool::worker {
+ public:
+  void run() noexcept;
+
+  // Called on this worker's thread while it's running a task.
+  void schedule_local(task_base* task) noexcept;
+
+  // Push a task onto the bottom of the deque, where thieves can see it.
+  void push_local(task_base* task) noexcept;
+
+  static thread_local worker* current_;
+
+  static_thread_pool* pool_ = nullptr;
+  std::uint32_t index_ = 0;
+  std::uint64_t rngState_ = 0;
+  std::uint32_t tick_ = 0;
+  std::uint32_t lifoRunCount_ = 0;
+  task_base* lifoSlot_ = nullptr;
+  chase_lev_deque<task_base> deque_;
+
+ private:
+  task_base* next_task() noexcept;
+
+  task_base* steal() noexcept;
+
+  // Returns false if the pool is stopping and there is no work left.
+  bool park() noexcept;
+
+  std::uint32_t random() noexcept {
+    // xorshift64
+    rngState_ ^= rngState_ << 13;
+    rngState_ ^= rngState_ >> 7;
+    rngState_ ^= rngState_ << 17;
+    return static_cast<std::uint32_t>(rngState_ >> 32);
+  }
+};
+
+thread_local static_thread_pool::worker*
+    static_thread_pool::worker::current_ = nullptr;
+
+void static_thread_pool::worker::run() noexcept {
+  current_ = this;
+  while (true) {
+    if (task_base* task = next_task()) {
+      task->execute();
+    } else if (!park()) {
+      break;
+    }
+  }
+  current_ = nullptr;
+}
+
+void static_thread_pool::worker::schedule_local(task_base* task) noexcept {
+  task_base* previous = std::exchange(lifoSlot_, task);
+  if (previous != nullptr) {
+    push_local(previous);
+    pool_->notify_one_parked();
+  }
+}
+
+void static_thread_pool::worker::push_local(task_base* task) noexcept {
+  try {
+    deque_.push(task);
+  } catch (...) {
+    // Couldn't grow the deque. The shared queue never needs to allocate.
+    pool_->enqueue_remote(task);
+  }
+}
+
+static_thread_pool::task_base*
+static_thread_pool::worker::next_task() noexcept {
+  if (++tick_ % remote_check_interval == 0) {
+    if (task_base* task = pool_->take_remote(*this)) {
+      return task;
+    }
+  }
+
+  if (lifoSlot_ != nullptr) {
+    if (++lifoRunCount_ <= max_lifo_runs) {
+      return std::exchange(lifoSlot_, nullptr);
+    }
+
+    // Run the oldest local task instead. The owner pops from the bottom of
+    // the deque so it has to steal from its own top to get at it.
+    lifoRunCount_ = 0;
+    push_local(std::exchange(lifoSlot_, nullptr));
+    if (task_base* task = deque_.steal()) {
+      return task;
+    }
+  }
+  lifoRunCount_ = 0;
+
+  if (task_base* task = deque_.pop()) {
+    return task;
+  }
+  if (task_base* task = pool_->take_remote(*this)) {
+    return task;
+  }
+  return steal();
+}
+
+static_thread_pool::task_base* static_thread_pool::worker::steal() noexcept {
+  const std::uint32_t count = pool_->threadCount_;
+  const std::uint32_t start = random() % count;
+  for (std::uint32_t i = 0; i < count; ++i) {
+    worker& victim = pool_->workers_[(start + i) % count];
+    if (&victim == this) {
+      continue;
+    }
+    if (task_base* task = victim.deque_.steal()) {
+      if (!victim.deque_.empty()) {
+        // Get some help with the rest of it.
+        pool_->notify_one_parked();
+      }
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+bool static_thread_pool::worker::park() noexcept {
+  // Read the epoch before advertising that we're parked so that we can't
+  // miss a notify_one_parked() from a thread that makes work available after
+  // our final check below.
+  const std::uint32_t epoch =
+      pool_->parkEpoch_.load(std::memory_order_acquire);
+  pool_->parkedCount_.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  bool keepRunning = true;
+  if (!pool_->has_work()) {
+    if (pool_->stop_.load(std::memory_order_acquire)) {
+      keepRunning = false;
+    } else {
+      pool_->parkEpoch_.wait(epoch, std::memory_order_acquire);
+    }
+  }
+
+  pool_->parkedCount_.fetch_sub(1, std::memory_order_relaxed);
+  return keepRunning;
+}
+
+static_thread_pool::static_thread_pool()
+  : static_thread_pool(std::max(1u, std::thread::hardware_concurrency())) {}
+
+static_thread_pool::static_thread_pool(std::uint32_t threadCount)
+  : threadCount_(threadCount), workers_(new worker[threadCount]) {
+  assert(threadCount > 0);
+  for (std::uint32_t i = 0; i < threadCount; ++i) {
+    worker& w = workers_[i];
+    w.pool_ = this;
+    w.index_ = i;
+    w.rngState_ = 0x9E3779B97F4A7C15ull * (i + 1);
+  }
+
+  threads_.reserve(threadCount);
+  try {
+    for (std::uint32_t i = 0; i < threadCount; ++i) {
+      threads_.emplace_back([w = &workers_[i]] { w->run(); });
+    }
+  } catch (...) {
+    stop_and_join();
+    throw;
+  }
+}
+
+static_thread_pool::~static_thread_pool() {
+  stop_and_join();
+  assert(remoteQueue_.empty());
+}
+
+void static_thread_pool::stop_and_join() noexcept {
+  stop_.store(true, std::memory_order_seq_cst);
+  parkEpoch_.fetch_add(1, std::memory_order_seq_cst);
+  parkEpoch_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void static_thread_pool::enqueue(task_base* task) noexcept {
+  worker* w = worker::current_;
+  if (w != nullptr && w->pool_ == this) {
+    w->schedule_local(task);
+  } else {
+    enqueue_remote(task);
+  }
+}
+
+void static_thread_pool::enqueue_remote(task_base* task) noexcept {
+  {
+    std::lock_guard lock{remoteMutex_};
+    remoteQueue_.push_back(task);
+    remoteCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+  notify_one_parked();
+}
+
+static_thread_pool::task_base*
+static_thread_pool::take_remote(worker& w) noexcept {
+  if (remoteCount_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+
+  // Take a fair share of the queue, leaving the rest for other workers.
+  intrusive_queue<task_base, &task_base::next_> batch;
+  {
+    std::lock_guard lock{remoteMutex_};
+    const std::size_t available = remoteCount_.load(std::memory_order_relaxed);
+    const std::size_t count =
+        std::min(available / threadCount_ + 1, max_remote_batch);
+    std::size_t taken = 0;
+    while (taken < count && !remoteQueue_.empty()) {
+      batch.push_back(remoteQueue_.pop_front());
+      ++taken;
+    }
+    remoteCount_.fetch_sub(taken, std::memory_order_relaxed);
+  }
+
+  if (batch.empty()) {
+    return nullptr;
+  }
+
+  task_base* first = batch.pop_front();
+  if (!batch.empty()) {
+    while (!batch.empty()) {
+      w.push_local(batch.pop_front());
+    }
+    notify_one_parked();
+  }
+  return first;
+}
+
+bool static_thread_pool::has_work() const noexcept {
+  if (remoteCount_.load(std::memory_order_relaxed) != 0) {
+    return true;
+  }
+  for (std::uint32_t i = 0; i < threadCount_; ++i) {
+    if (!workers_[i].deque_.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void static_thread_pool::notify_one_parked() noexcept {
+  // Pairs with the fence in worker::park(). Either the parking worker sees
+  // the work we just made available or we see it in parkedCount_.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parkedCount_.load(std::memory_order_relaxed) != 0) {
+    parkEpoch_.fetch_add(1, std::memory_order_release);
+    parkEpoch_.notify_one();
+  }
+}
+
+} // namespace unifex
@@ -15,16 +15,35 @@
  */
 #include <unifex/thread_unsafe_event_loop.hpp>
 
+#include <algorithm>
 #include <thread>
 
 namespace unifex {
 
+thread_unsafe_event_loop::thread_unsafe_event_loop(
+    timer_backend backend,
+    std::chrono::nanoseconds wheelTick) noexcept {
+  if (backend == timer_backend::timing_wheel) {
+    const auto tick = std::max(
+        std::chrono::ceil<clock_t::duration>(wheelTick),
+        clock_t::duration{1});
+    wheel_.emplace(clock_t::now(), tick);
+  }
+}
+
 void thread_unsafe_event_loop::cancel_callback::operator()() noexcept {
   auto now = clock_t::now();
   if (now < op_->dueTime_) {
     op_->dueTime_ = now;
 
-    if (op_->prevPtr_ != nullptr) {
+    auto& loop = op_->loop_;
+    if (loop.wheel_.has_value()) {
+      // An operation that was not yet due must still be in the wheel.
+      if (op_->prevPtr_ != nullptr) {
+        loop.wheel_->remove(op_);
+        loop.ready_.push_back(op_);
+      }
+    } else if (op_->prevPtr_ != nullptr) {
       // Task is still in the queue, dequeue and requeue it.
 
       // Remove from the queue.
@@ -41,6 +60,16 @@ void thread_unsafe_event_loop::cancel_callback::operator()() noexcept {
 }
 
 void thread_unsafe_event_loop::enqueue(operation_base* op) noexcept {
+  if (wheel_.has_value()) {
+    if (op->dueTime_ > clock_t::now()) {
+      wheel_->insert(op);
+    } else {
+      op->prevPtr_ = nullptr;
+      ready_.push_back(op);
+    }
+    return;
+  }
+
   auto* current = head_;
   if (current == nullptr || op->dueTime_ < current->dueTime_) {
     // insert at head of list
@@ -69,6 +98,22 @@ void thread_unsafe_event_loop::enqueue(operation_base* op) noexcept {
 }
 
 void thread_unsafe_event_loop::run_until_empty() noexcept {
+  if (wheel_.has_value()) {
+    while (!ready_.empty() || !wheel_->empty()) {
+      if (!wheel_->empty()) {
+        // Move any timers that have elapsed onto the ready queue.
+        ready_.append(wheel_->pop_expired(clock_t::now()));
+        if (ready_.empty()) {
+          std::this_thread::sleep_until(*wheel_->next_expiry_time());
+          continue;
+        }
+      }
+
+      ready_.pop_front()->execute();
+    }
+    return;
+  }
+
   auto lastTime = clock_t::now();
   while (head_ != nullptr) {
     if (head_->dueTime_ > lastTime) {
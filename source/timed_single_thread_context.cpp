@@ -15,10 +15,35 @@
  */
 #include <unifex/timed_single_thread_context.hpp>
 
+#include <algorithm>
+
 namespace unifex {
 
+namespace {
+
+// The timing wheel needs a tick of at least one clock period.
+timed_single_thread_context::clock_t::duration clamp_wheel_tick(
+    std::chrono::nanoseconds tick) noexcept {
+  using duration = timed_single_thread_context::clock_t::duration;
+  return std::max(std::chrono::ceil<duration>(tick), duration{1});
+}
+
+} // namespace
+
 timed_single_thread_context::timed_single_thread_context()
-: thread_([this] { this->run(); })
+: timed_single_thread_context(timer_backend::priority_queue)
+{}
+
+timed_single_thread_context::timed_single_thread_context(
+    timer_backend backend,
+    std::chrono::nanoseconds wheelTick)
+: wheel_(
+      backend == timer_backend::timing_wheel
+          ? std::optional<timer_wheel>{std::in_place,
+                                       clock_t::now(),
+                                       clamp_wheel_tick(wheelTick)}
+          : std::nullopt)
+, thread_([this] { this->run(); })
 {}
 
 timed_single_thread_context::~timed_single_thread_context() {
@@ -28,98 +53,162 @@ timed_single_thread_context::~timed_single_thread_context() {
     cv_.notify_one();
   }
   thread_.join();
-
-  assert(head_ == nullptr);
 }
 
 void timed_single_thread_context::enqueue(task_base* task) noexcept {
-  std::lock_guard lock{mutex_};
-
-  if (head_ == nullptr || task->dueTime_ < head_->dueTime_) {
-    // Insert at the head of the queue.
-    task->next_ = head_;
-    task->prevNextPtr_ = &head_;
-    if (head_ != nullptr) {
-      head_->prevNextPtr_ = &task->next_;
-    }
-    head_ = task;
+  send_request(&task->scheduleRequest_);
+}
 
-    // New minimum due-time has changed, wake the thread.
+void timed_single_thread_context::send_request(
+    remote_request* request) noexcept {
+  if (remoteQueue_.enqueue(request)) {
+    // The timer thread has gone to sleep (or is about to) and we are the
+    // first to send it a request since then. Wake it up.
+    std::lock_guard lock{mutex_};
+    wakeRequested_ = true;
     cv_.notify_one();
-  } else {
-    auto* queuedTask = head_;
-    while (queuedTask->next_ != nullptr &&
-           queuedTask->next_->dueTime_ <= task->dueTime_) {
-      queuedTask = queuedTask->next_;
-    }
-
-    // Insert after queuedTask
-    task->prevNextPtr_ = &queuedTask->next_;
-    task->next_ = queuedTask->next_;
-    if (task->next_ != nullptr) {
-      task->next_->prevNextPtr_ = &task->next_;
-    }
-    queuedTask->next_ = task;
   }
 }
 
 void timed_single_thread_context::run() {
-  std::unique_lock lock{mutex_};
-
-  while (!stop_) {
-    if (head_ != nullptr) {
-      auto now = clock_t::now();
-      auto nextDueTime = head_->dueTime_;
-      if (nextDueTime <= now) {
-        // Ready to run
-
-        // Dequeue item
-        auto* task = head_;
-        head_ = task->next_;
-        if (head_ != nullptr) {
-          head_->prevNextPtr_ = &head_;
+  while (true) {
+    process_requests(remoteQueue_.dequeue_all());
+    run_elapsed_tasks();
+
+    // Check for requests one last time while marking the queue inactive.
+    auto requests = remoteQueue_.try_mark_inactive_or_dequeue_all();
+    if (!requests.empty()) {
+      process_requests(std::move(requests));
+      continue;
+    }
+
+    {
+      std::unique_lock lock{mutex_};
+      const auto dueTime = next_due_time();
+      while (!wakeRequested_ && !stop_) {
+        if (!dueTime) {
+          cv_.wait(lock);
+        } else if (
+            cv_.wait_until(lock, *dueTime) == std::cv_status::timeout) {
+          break;
         }
+      }
+      if (stop_) {
+        return;
+      }
+      wakeRequested_ = false;
+    }
 
-        // Flag the task as dequeued.
-        task->prevNextPtr_ = nullptr;
-        lock.unlock();
+    // If we woke up because a timer is due then nobody has marked the queue
+    // as active again yet.
+    (void)remoteQueue_.try_mark_active();
+  }
+}
 
-        task->execute();
+void timed_single_thread_context::process_requests(
+    intrusive_queue<remote_request, &remote_request::next_> requests) noexcept {
+  std::optional<time_point> now;
+  while (!requests.empty()) {
+    remote_request* request = requests.pop_front();
+    task_base* task = request->task_;
+
+    if (request == &task->cancelRequest_) {
+      switch (task->location_) {
+        case task_base::location::submitted:
+        case task_base::location::ready:
+          // Run it as soon as it's dequeued.
+          task->cancelled_ = true;
+          break;
+        case task_base::location::queued:
+          if (wheel_.has_value()) {
+            wheel_->remove(task);
+          } else {
+            timers_.remove(task);
+          }
+          task->location_ = task_base::location::detached;
+          task->execute();
+          break;
+        case task_base::location::detached:
+          // It elapsed but left completing it to us.
+          task->execute();
+          break;
+      }
+      continue;
+    }
 
-        lock.lock();
+    assert(request == &task->scheduleRequest_);
+    if (task->cancelled_) {
+      task->location_ = task_base::location::detached;
+      task->execute();
+    } else if (wheel_.has_value()) {
+      if (!now) {
+        now = clock_t::now();
+      }
+      if (task->dueTime_ > *now) {
+        task->location_ = task_base::location::queued;
+        wheel_->insert(task);
       } else {
-        // Not yet ready to run. Sleep until it's ready.
-        cv_.wait_until(lock, nextDueTime);
+        task->location_ = task_base::location::ready;
+        ready_.push_back(task);
       }
     } else {
-      // Queue is empty.
-      cv_.wait(lock);
+      task->location_ = task_base::location::queued;
+      timers_.insert(task);
     }
   }
 }
 
-void timed_single_thread_context::cancel_callback::operator()() noexcept {
-  std::unique_lock lock{task_->context_->mutex_};
-  auto now = clock_t::now();
-  if (now < task_->dueTime_) {
-    task_->dueTime_ = now;
-
-    if (task_->prevNextPtr_ != nullptr) {
-      // Task is still in the queue, dequeue and requeue it.
-
-      // Remove from the queue.
-      *task_->prevNextPtr_ = task_->next_;
-      if (task_->next_ != nullptr) {
-        task_->next_->prevNextPtr_ = task_->prevNextPtr_;
-      }
-      task_->prevNextPtr_ = nullptr;
-      lock.unlock();
+void timed_single_thread_context::run_elapsed_tasks() noexcept {
+  const auto now = clock_t::now();
+  if (wheel_.has_value()) {
+    auto elapsed = wheel_->pop_expired(now);
+    while (!elapsed.empty()) {
+      task_base* task = elapsed.pop_front();
+      task->location_ = task_base::location::ready;
+      ready_.push_back(task);
+    }
+    while (!ready_.empty()) {
+      run_elapsed_task(ready_.pop_front());
+    }
+  } else {
+    while (!timers_.empty() && timers_.top()->dueTime_ <= now) {
+      run_elapsed_task(timers_.pop());
+    }
+  }
+}
 
-      // And requeue with an updated time.
-      task_->dueTime_ = now;
-      task_->context_->enqueue(task_);
+void timed_single_thread_context::run_elapsed_task(task_base* task) noexcept {
+  task->location_ = task_base::location::detached;
+  if (!task->cancelled_) {
+    auto oldState = task->state_.fetch_or(
+        task_base::elapsed_flag, std::memory_order_acq_rel);
+    if ((oldState & task_base::cancel_pending_flag) != 0) {
+      // A cancel request is on its way and will complete the task.
+      return;
     }
   }
+  task->execute();
+}
+
+std::optional<timed_single_thread_context::time_point>
+timed_single_thread_context::next_due_time() const noexcept {
+  if (wheel_.has_value()) {
+    return wheel_->next_expiry_time();
+  }
+  if (!timers_.empty()) {
+    return timers_.top()->dueTime_;
+  }
+  return std::nullopt;
+}
+
+void timed_single_thread_context::cancel_callback::operator()() noexcept {
+  auto oldState = task_->state_.fetch_or(
+      task_base::cancel_pending_flag, std::memory_order_acq_rel);
+  if ((oldState & task_base::elapsed_flag) == 0) {
+    // The task has not elapsed yet so the timer thread leaves completing
+    // it to our cancel request.
+    task_->context_->send_request(&task_->cancelRequest_);
+  }
 }
 
 } // namespace unifex